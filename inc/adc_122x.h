@@ -37,6 +37,7 @@
 #ifndef __ADC_122X_H_
 #define __ADC_122X_H_
 
+#include "ring_buffer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -79,9 +80,10 @@ typedef struct {					/*!< ADCn Structure */
 #define ADC_CR_START_NOW        ((1UL << 24))			/*!< Start conversion now */
 #define ADC_CR_START_CTOUT15    ((2UL << 24))			/*!< Start conversion when the edge selected by bit 27 occurs on CTOUT_15 */
 #define ADC_CR_START_CTOUT8     ((3UL << 24))			/*!< Start conversion when the edge selected by bit 27 occurs on CTOUT_8 */
-#define ADC_CR_START_ADCTRIG0   ((4UL << 24))			/*!< Start conversion when the edge selected by bit 27 occurs on ADCTRIG0 */
-#define ADC_CR_START_ADCTRIG1   ((5UL << 24))			/*!< Start conversion when the edge selected by bit 27 occurs on ADCTRIG1 */
-#define ADC_CR_START_MCOA2      ((6UL << 24))			/*!< Start conversion when the edge selected by bit 27 occurs on Motocon PWM output MCOA2 */
+#define ADC_CR_START_CT32B0_MAT0    ((4UL << 24))		/*!< Start conversion when the edge selected by bit 27 occurs on CT32B0_MAT0 */
+#define ADC_CR_START_CT32B0_MAT1    ((5UL << 24))		/*!< Start conversion when the edge selected by bit 27 occurs on CT32B0_MAT1 */
+#define ADC_CR_START_CT16B0_MAT0    ((6UL << 24))		/*!< Start conversion when the edge selected by bit 27 occurs on CT16B0_MAT0 */
+#define ADC_CR_START_CT16B0_MAT1    ((7UL << 24))		/*!< Start conversion when the edge selected by bit 27 occurs on CT16B0_MAT1 */
 #define ADC_CR_EDGE             ((1UL << 27))			/*!< Start conversion on a falling edge on the selected CAP/MAT signal */
 #define ADC_SAMPLE_RATE_CONFIG_MASK         (ADC_CR_CLKDIV(0xFF) | ADC_CR_BITACC(0x07))
 
@@ -130,9 +132,10 @@ typedef enum CHIP_ADC_START_MODE {
 	ADC_START_NOW,			/*!< Start conversion now */
 	ADC_START_ON_CTOUT15,	/*!< Start conversion when the edge selected by bit 27 occurs on CTOUT_15 */
 	ADC_START_ON_CTOUT8,	/*!< Start conversion when the edge selected by bit 27 occurs on CTOUT_8 */
-	ADC_START_ON_ADCTRIG0,	/*!< Start conversion when the edge selected by bit 27 occurs on ADCTRIG0 */
-	ADC_START_ON_ADCTRIG1,	/*!< Start conversion when the edge selected by bit 27 occurs on ADCTRIG1 */
-	ADC_START_ON_MCOA2		/*!< Start conversion when the edge selected by bit 27 occurs on Motocon PWM output MCOA2 */
+	ADC_START_ON_CT32B0_MAT0,	/*!< Start conversion when the edge selected by bit 27 occurs on CT32B0_MAT0 */
+	ADC_START_ON_CT32B0_MAT1,	/*!< Start conversion when the edge selected by bit 27 occurs on CT32B0_MAT1 */
+	ADC_START_ON_CT16B0_MAT0,	/*!< Start conversion when the edge selected by bit 27 occurs on CT16B0_MAT0 */
+	ADC_START_ON_CT16B0_MAT1,	/*!< Start conversion when the edge selected by bit 27 occurs on CT16B0_MAT1 */
 } ADC_START_MODE_T;
 
 /** Clock setup structure for ADC controller passed to the initialize function */
@@ -213,9 +216,10 @@ STATIC INLINE void Chip_ADC_Int_SetGlobalCmd(LPC_ADC_T *pADC, FunctionalState Ne
  *							- ADC_START_NOW				: Start conversion now
  *							- ADC_START_ON_CTOUT15		: Start conversion when the edge selected by bit 27 occurs on CTOUT_15
  *							- ADC_START_ON_CTOUT8		: Start conversion when the edge selected by bit 27 occurs on CTOUT_8
- *							- ADC_START_ON_ADCTRIG0		: Start conversion when the edge selected by bit 27 occurs on ADCTRIG0
- *							- ADC_START_ON_ADCTRIG1		: Start conversion when the edge selected by bit 27 occurs on ADCTRIG1
- *							- ADC_START_ON_MCOA2		: Start conversion when the edge selected by bit 27 occurs on Motocon PWM output MCOA2
+ *							- ADC_START_ON_CT32B0_MAT0	: Start conversion when the edge selected by bit 27 occurs on CT32B0_MAT0
+ *							- ADC_START_ON_CT32B0_MAT1	: Start conversion when the edge selected by bit 27 occurs on CT32B0_MAT1
+ *							- ADC_START_ON_CT16B0_MAT0	: Start conversion when the edge selected by bit 27 occurs on CT16B0_MAT0
+ *							- ADC_START_ON_CT16B0_MAT1	: Start conversion when the edge selected by bit 27 occurs on CT16B0_MAT1
  * @param	EdgeOption	: Stating Edge Condition, should be :
  *							- ADC_TRIGGERMODE_RISING	: Trigger event on rising edge
  *							- ADC_TRIGGERMODE_FALLING	: Trigger event on falling edge
@@ -262,6 +266,275 @@ void Chip_ADC_EnableChannel(LPC_ADC_T *pADC, ADC_CHANNEL_T channel, FunctionalSt
  */
 void Chip_ADC_SetBurstCmd(LPC_ADC_T *pADC, FunctionalState NewState);
 
+/** Sample flag: the result is stale or an earlier result of the channel was lost */
+#define ADC_SCAN_OVERRUN        (1 << 15)
+
+/** Highest CIC decimator order of the oversampling stage */
+#define ADC_CIC_MAX_ORDER       3
+
+/** Per-channel oversampling state */
+typedef struct {
+	uint32_t integ[ADC_CIC_MAX_ORDER];	/*!< CIC integrators, wrap around by design */
+	uint32_t comb[ADC_CIC_MAX_ORDER];	/*!< CIC comb delays */
+	uint32_t iir;						/*!< IIR state, output scaled by 2^iirShift */
+	volatile uint16_t value;			/*!< Latest filtered output, 10 + osShift bits */
+} ADC_OSCHAN_T;
+
+typedef struct ADC_OVERSAMPLE ADC_OVERSAMPLE_T;
+
+/**
+ * @brief ADC oversampling callback, called from the ADC interrupt for each new output
+ */
+typedef void (*ADC_OVERSAMPLE_CALLBACK_T)(ADC_OVERSAMPLE_T *os);
+
+/** ADC oversampling stage structure */
+struct ADC_OVERSAMPLE {
+	ADC_OSCHAN_T *chan;					/*!< State of each channel, lowest channel first */
+	uint8_t numChannels;				/*!< Number of channels */
+	uint8_t osShift;					/*!< 4^osShift scans give one output with osShift extra bits */
+	uint8_t cicOrder;					/*!< CIC decimator order, 1 for a moving average */
+	uint8_t iirShift;					/*!< One-pole IIR coefficient 2^-iirShift, 0 to disable */
+	uint8_t outShift;					/*!< Used by the driver */
+	uint8_t warmup;						/*!< Used by the driver, outputs left before the first valid one */
+	uint32_t count;						/*!< Used by the driver, scans in the current output */
+	ADC_OVERSAMPLE_CALLBACK_T callback;	/*!< New output callback, may be NULL */
+	void *data;							/*!< Application data, not used by the driver */
+};
+
+/** Scan buffer events passed to the scan callback */
+typedef enum CHIP_ADC_SCAN_EVENT {
+	ADC_SCAN_HALF,		/**< First half of the buffer is filled */
+	ADC_SCAN_FULL,		/**< Second half of the buffer is filled, filling restarts at the start */
+} ADC_SCAN_EVENT_T;
+
+typedef struct ADC_SCAN ADC_SCAN_T;
+
+/**
+ * @brief ADC scan callback, called from the ADC interrupt
+ * @param	scan	: Scan passed to Chip_ADC_ScanStart()
+ * @param	event	: Which half of the buffer is ready
+ * @param	samples	: First sample of the ready half, numScans / 2 scans
+ */
+typedef void (*ADC_SCAN_CALLBACK_T)(ADC_SCAN_T *scan, ADC_SCAN_EVENT_T event, uint16_t *samples);
+
+/** ADC burst scan structure */
+struct ADC_SCAN {
+	uint8_t channels;				/*!< OR'ed ADC_CR_CH_SEL() of the scanned channels */
+	uint16_t *buffer;				/*!< Circular buffer, one sample per channel for each scan, lowest channel first */
+	uint32_t numScans;				/*!< Buffer size in scans, even and at least 2 */
+	uint32_t scanRate;				/*!< Scans per second */
+	ADC_SCAN_CALLBACK_T callback;	/*!< Half / full buffer callback, may be NULL */
+	void *data;						/*!< Application data, not used by the driver */
+	ADC_OVERSAMPLE_T *oversample;	/*!< Fed with each scan from the interrupt, may be NULL */
+	uint8_t numChannels;			/*!< Used by the driver */
+	volatile uint32_t index;		/*!< Used by the driver, next scan to fill */
+};
+
+/**
+ * @brief	Set up an oversampling stage
+ * @param	os			: Oversampling stage to set up
+ * @param	chan		: State for @a numChannels channels
+ * @param	numChannels	: Number of channels, as in the scan feeding the stage
+ * @param	osShift		: Decimation by 4^osShift, for osShift extra bits (0 to 6)
+ * @param	cicOrder	: CIC decimator order, 1 to #ADC_CIC_MAX_ORDER
+ * @param	iirShift	: IIR low-pass coefficient 2^-iirShift (0 to 15), 0 to disable
+ * @return	ERROR if the parameters are out of range, SUCCESS otherwise
+ * @note
+ * Each scan runs the CIC integrators of every channel. Every 4^osShift
+ * scans the combs produce one output per channel, scaled to 10 + osShift
+ * bits, which then goes through the IIR filter. The stage only uses
+ * adds and shifts. The bit growth of the integrators must fit 32 bits,
+ * 10 + 2 * osShift * cicOrder <= 32.
+ */
+Status Chip_ADC_OversampleInit(ADC_OVERSAMPLE_T *os, ADC_OSCHAN_T *chan, uint8_t numChannels,
+							   uint8_t osShift, uint8_t cicOrder, uint8_t iirShift);
+
+/**
+ * @brief	Feed one scan to an oversampling stage
+ * @param	os			: Oversampling stage
+ * @param	samples		: One sample per channel, #ADC_SCAN_OVERRUN is ignored
+ * @return	Nothing
+ * @note	Called by Chip_ADC_ScanIRQHandler() when set in the scan setup
+ */
+void Chip_ADC_OversampleInput(ADC_OVERSAMPLE_T *os, const uint16_t *samples);
+
+/**
+ * @brief	Read the latest output of an oversampling stage
+ * @param	os			: Oversampling stage
+ * @param	index		: Channel index in the scan, 0 for the lowest channel
+ * @return	Filtered value with 10 + @a os->osShift bits
+ */
+STATIC INLINE uint16_t Chip_ADC_OversampleRead(ADC_OVERSAMPLE_T *os, uint8_t index)
+{
+	return os->chan[index].value;
+}
+
+/**
+ * @brief	Start continuous burst conversion of a channel list
+ * @param	pADC		: The base of ADC peripheral on the chip
+ * @param	ADCSetup	: ADC setup structure, the burst mode and sample rate are updated
+ * @param	scan		: Scan setup, must stay valid until Chip_ADC_ScanStop()
+ * @return	ERROR if the scan setup is not valid or its rate cannot be reached, SUCCESS otherwise
+ * @note
+ * The ADC clock is set for @a scan->scanRate scans per second with the
+ * resolution in @a ADCSetup, and @a scan->scanRate is updated with the
+ * achieved rate. The rate cannot be reached when it needs a divider
+ * above 255 or an ADC clock above its limit. Each time the highest channel of the list
+ * is converted, Chip_ADC_ScanIRQHandler() stores the results of all the
+ * channels as one scan of @a scan->buffer. The low bits of a sample hold
+ * the result and #ADC_SCAN_OVERRUN is set when samples were lost, for
+ * example because the interrupt was held off for more than a scan. The
+ * ADC interrupt must be enabled in the NVIC.
+ */
+Status Chip_ADC_ScanStart(LPC_ADC_T *pADC, ADC_CLOCK_SETUP_T *ADCSetup, ADC_SCAN_T *scan);
+
+/**
+ * @brief	Stop the burst scan
+ * @param	pADC		: The base of ADC peripheral on the chip
+ * @param	ADCSetup	: ADC setup structure, the burst mode is cleared
+ * @return	Nothing
+ */
+void Chip_ADC_ScanStop(LPC_ADC_T *pADC, ADC_CLOCK_SETUP_T *ADCSetup);
+
+/**
+ * @brief	Start sampling one channel at a fixed rate set by a timer match
+ * @param	pADC		: The base of ADC peripheral on the chip
+ * @param	ADCSetup	: ADC setup structure, the burst mode is cleared
+ * @param	scan		: Scan setup with a single channel, @a scan->scanRate is
+ *						  the target sample rate and is set to the achieved rate
+ * @param	pTimer		: LPC_TIMER32_0 or LPC_TIMER16_0, used only for the sampling clock
+ * @param	matchnum	: Match register 0 or 1
+ * @return	Achieved sample rate, 0 if the setup is not valid or the rate
+ *			is above @a ADCSetup->adcRate
+ * @note
+ * Each conversion is started by the rising edge of the timer match
+ * output, which toggles every half sample period, so the sample spacing
+ * does not depend on software. The samples are stored by
+ * Chip_ADC_ScanIRQHandler() as for Chip_ADC_ScanStart(). The timer is
+ * scaled to the closest period, a 16-bit timer uses the prescaler only
+ * when the period does not fit the match register.
+ */
+uint32_t Chip_ADC_SampleStart(LPC_ADC_T *pADC, ADC_CLOCK_SETUP_T *ADCSetup, ADC_SCAN_T *scan,
+							  LPC_TIMER_T *pTimer, int8_t matchnum);
+
+/**
+ * @brief	Stop timer triggered sampling
+ * @param	pADC		: The base of ADC peripheral on the chip
+ * @param	ADCSetup	: ADC setup structure
+ * @param	pTimer		: Timer passed to Chip_ADC_SampleStart()
+ * @return	Nothing
+ */
+void Chip_ADC_SampleStop(LPC_ADC_T *pADC, ADC_CLOCK_SETUP_T *ADCSetup, LPC_TIMER_T *pTimer);
+
+/**
+ * @brief	ADC interrupt handler for the burst scan
+ * @param	pADC		: The base of ADC peripheral on the chip
+ * @return	Nothing
+ * @note	Must be called from the ADC interrupt handler when using Chip_ADC_ScanStart()
+ *			or Chip_ADC_SampleStart()
+ */
+void Chip_ADC_ScanIRQHandler(LPC_ADC_T *pADC);
+
+/** ADC watchdog events */
+typedef enum CHIP_ADC_WD_EVENT {
+	ADC_WD_INSIDE,		/**< Result is back inside the window */
+	ADC_WD_BELOW,		/**< Result is below the low threshold */
+	ADC_WD_ABOVE,		/**< Result is above the high threshold */
+	ADC_WD_TRIP,		/**< First-level trip posted with Chip_ADC_WatchdogTrip() */
+} ADC_WD_EVENT_T;
+
+/** ADC watchdog event queue entry */
+typedef struct {
+	uint32_t timestamp;	/*!< Timer count when the event was posted, 0 without timer */
+	uint16_t value;		/*!< Result that caused the event, 0 for a trip */
+	uint8_t channel;	/*!< ADC channel, or trip source for #ADC_WD_TRIP */
+	uint8_t event;		/*!< ADC_WD_EVENT_T */
+} ADC_WD_ENTRY_T;
+
+/** ADC watchdog structure */
+typedef struct {
+	uint16_t low[8];			/*!< Low threshold of each channel */
+	uint16_t high[8];			/*!< High threshold of each channel */
+	uint8_t channels;			/*!< OR'ed ADC_CR_CH_SEL() of the channels with a window */
+	uint8_t state[8];			/*!< Used by the driver, last event of each channel */
+	RINGBUFF_T *events;			/*!< Event queue of ADC_WD_ENTRY_T items */
+	LPC_TIMER_T *pTimer;		/*!< Free running timer for the timestamps, may be NULL */
+	volatile uint32_t lost;		/*!< Events dropped because the queue was full */
+} ADC_WATCHDOG_T;
+
+/**
+ * @brief	Set up an ADC watchdog
+ * @param	wd			: Watchdog to set up, no window is set
+ * @param	events		: Event queue, initialized with ADC_WD_ENTRY_T items
+ * @param	pTimer		: Running timer used for the timestamps, NULL for none
+ * @return	ERROR if the queue item size is wrong, SUCCESS otherwise
+ * @note	The queue is filled from the interrupt and emptied by the
+ *			application with RingBuffer_Pop().
+ */
+Status Chip_ADC_WatchdogInit(ADC_WATCHDOG_T *wd, RINGBUFF_T *events, LPC_TIMER_T *pTimer);
+
+/**
+ * @brief	Set the window of a channel
+ * @param	wd			: Watchdog
+ * @param	channel		: ADC channel
+ * @param	low			: Lowest result inside the window
+ * @param	high		: Highest result inside the window
+ * @return	Nothing
+ * @note	The channel is assumed inside the window, the first result
+ *			outside of it posts an event.
+ */
+void Chip_ADC_WatchdogSetWindow(ADC_WATCHDOG_T *wd, ADC_CHANNEL_T channel, uint16_t low, uint16_t high);
+
+/**
+ * @brief	Remove the window of a channel
+ * @param	wd			: Watchdog
+ * @param	channel		: ADC channel
+ * @return	Nothing
+ */
+void Chip_ADC_WatchdogClearWindow(ADC_WATCHDOG_T *wd, ADC_CHANNEL_T channel);
+
+/**
+ * @brief	Start checking conversion results against the windows
+ * @param	pADC		: The base of ADC peripheral on the chip
+ * @param	wd			: Watchdog
+ * @return	Nothing
+ * @note
+ * Only a change of a channel between below, inside and above its window
+ * posts an event. While a scan is running, Chip_ADC_ScanIRQHandler()
+ * checks the scanned channels. Otherwise the DONE interrupt of each
+ * window channel is enabled with Chip_ADC_Int_SetChannelCmd() and
+ * Chip_ADC_WatchdogIRQHandler() must be called from the ADC interrupt
+ * handler. The conversions are started by the application, burst mode
+ * being the usual choice. Set the windows before starting.
+ */
+void Chip_ADC_WatchdogStart(LPC_ADC_T *pADC, ADC_WATCHDOG_T *wd);
+
+/**
+ * @brief	Stop the ADC watchdog
+ * @param	pADC		: The base of ADC peripheral on the chip
+ * @return	Nothing
+ */
+void Chip_ADC_WatchdogStop(LPC_ADC_T *pADC);
+
+/**
+ * @brief	ADC interrupt handler for the watchdog without a scan
+ * @param	pADC		: The base of ADC peripheral on the chip
+ * @return	Nothing
+ */
+void Chip_ADC_WatchdogIRQHandler(LPC_ADC_T *pADC);
+
+/**
+ * @brief	Post a first-level trip event
+ * @param	wd			: Watchdog
+ * @param	source		: Trip source, stored as the event channel
+ * @return	Nothing
+ * @note	Meant to be called from the comparator interrupt, which trips
+ *			without waiting for a conversion. The queue has a single
+ *			producer, so that interrupt must have the same priority as
+ *			the ADC interrupt.
+ */
+void Chip_ADC_WatchdogTrip(ADC_WATCHDOG_T *wd, uint8_t source);
+
 /**
  * @}
  */
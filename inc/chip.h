@@ -134,11 +134,13 @@ warning message, define ENABLE_UNTESTED_CODE.
 #define LPC_SSP0_BASE             0x40040000
 #define LPC_IOCON_BASE            0x40044000
 #define LPC_SYSCTL_BASE           0x40048000
+#define LPC_DMA_BASE              0x4004C000
 #define LPC_RTC_BASE			  0x40050000
 
 #define LPC_GPIO_PORT0_BASE       0x50000000
 #define LPC_GPIO_PORT1_BASE       0x50010000
 #define LPC_GPIO_PORT2_BASE       0x50020000
+#define LPC_CRC_BASE              0x50070000
 
 #define IAP_ENTRY_LOCATION        0X1FFF1FF1
 #define LPC_ROM_API_BASE_LOC      0x1FFF1FF8
@@ -155,6 +157,7 @@ warning message, define ENABLE_UNTESTED_CODE.
 #define LPC_TIMER32_1             ((LPC_TIMER_T            *) LPC_TIMER32_1_BASE)
 #define LPC_ADC                   ((LPC_ADC_T              *) LPC_ADC_BASE)
 #define LPC_CMP                   ((LPC_CMP_T              *) LPC_ACMP_BASE)
+#define LPC_DMA                   ((LPC_DMA_T              *) LPC_DMA_BASE)
 #define LPC_PMU                   ((LPC_PMU_T              *) LPC_PMU_BASE)
 //#define LPC_FMC                   ((LPC_FMC_T              *) LPC_FLASH_BASE)
 #define LPC_SSP0                  ((LPC_SSP_T              *) LPC_SSP0_BASE)
@@ -162,6 +165,7 @@ warning message, define ENABLE_UNTESTED_CODE.
 #define LPC_SYSCTL                ((LPC_SYSCTL_T           *) LPC_SYSCTL_BASE)
 #define LPC_RTC					  ((LPC_RTC_T)             *) LPC_RTC_BASE)
 #define LPC_GPIO                  ((LPC_GPIO_T             *) LPC_GPIO_PORT0_BASE)
+#define LPC_CRC                   ((LPC_CRC_T              *) LPC_CRC_BASE)
 //#define LPC_ROM_API               (*((LPC_ROM_API_T        * *) LPC_ROM_API_BASE_LOC))
 
 
@@ -209,10 +213,13 @@ extern const uint32_t ExtRateIn;
 #include "wwdt_122x.h"
 #include "ssp_122x.h"
 #include "adc_122x.h"
+#include "cmp_122x.h"
 #include "gpio_122x.h"
 #include "i2c_122x.h"
 #include "pinint_122x.h"
 #include "rtc_122x.h"
+#include "dma_122x.h"
+#include "crc_122x.h"
 
 
 
@@ -0,0 +1,272 @@
+/*
+ * @brief LPC122x analog comparator chip driver
+ *
+ * @note
+ * WARNING: THIS LIBRARY HAS BEEN PORTED TO LPC122x devices from the lpc_chip_11u14 LPCOPEN chip library. Please consider this when using it.
+ * This library is provided as is, and the authors DO NOT GUARANTEE that it is working.
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2012
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __CMP_122X_H_
+#define __CMP_122X_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup CMP_122X CHIP: LPC122x Analog comparator driver
+ * @ingroup CHIP_122X_Drivers
+ * @{
+ */
+
+/**
+ * @brief Analog comparator register block structure
+ */
+typedef struct {				/*!< CMP Structure          */
+	__IO uint32_t CMP;			/*!< Comparator control register */
+	__IO uint32_t VLAD;			/*!< Voltage ladder register */
+} LPC_CMP_T;
+
+/**
+ * @brief Comparator control register bit definitions
+ */
+#define CMP_EN(n)               (1UL << (n))				/*!< Comparator n enable */
+#define CMP_ROSCCTL             (1UL << 2)					/*!< Ring oscillator control */
+#define CMP_EXT_RESET           (1UL << 3)					/*!< Ring oscillator reset source */
+#define CMP_VP_CTRL(n, in)      ((uint32_t) (in) << (8 + ((n) * 6)))	/*!< Comparator n positive input */
+#define CMP_VM_CTRL(n, in)      ((uint32_t) (in) << (11 + ((n) * 6)))	/*!< Comparator n negative input */
+#define CMP_INPUT_MASK(n)       (0x3FUL << (8 + ((n) * 6)))	/*!< Comparator n input selection bits */
+#define CMP_SYNC(n)             (1UL << (20 + (n)))		/*!< Synchronize comparator n output with the bus clock */
+#define CMP_HYS(n)              (1UL << (22 + (n)))		/*!< Comparator n hysteresis enable */
+#define CMP_INTPOL(n)           (1UL << (24 + (n)))		/*!< Comparator n interrupt on rising (1) or falling (0) edge */
+#define CMP_INTBOTH(n)          (1UL << (26 + (n)))		/*!< Comparator n interrupt on both edges */
+#define CMP_STAT(n)             (1UL << (28 + (n)))		/*!< Comparator n output */
+#define CMP_INT(n)              (1UL << (30 + (n)))		/*!< Comparator n edge detected, write 1 to clear */
+#define CMP_INT_MASK            (CMP_INT(0) | CMP_INT(1))
+
+/**
+ * @brief Voltage ladder register bit definitions
+ */
+#define CMP_VLAD_EN             (1UL << 0)					/*!< Voltage ladder enable */
+#define CMP_VLAD_VSEL(n)        (((n) & 0x1F) << 1)		/*!< Ladder output, n/31 of the reference */
+#define CMP_VLAD_REF_VDDCMP     (1UL << 6)					/*!< Ladder reference is the VDDCMP pin, VDD(3V3) otherwise */
+
+/** Comparators */
+typedef enum CHIP_CMP_ID {
+	CMP_ID0 = 0,			/**< Comparator 0 */
+	CMP_ID1,				/**< Comparator 1 */
+} CMP_ID_T;
+
+/** Comparator inputs */
+typedef enum CHIP_CMP_INPUT {
+	CMP_INPUT_VLAD = 0,		/**< Voltage ladder output */
+	CMP_INPUT_I0,			/**< ACMPn_I0 pin */
+	CMP_INPUT_I1,			/**< ACMPn_I1 pin */
+	CMP_INPUT_I2,			/**< ACMPn_I2 pin */
+	CMP_INPUT_I3,			/**< ACMPn_I3 pin */
+	CMP_INPUT_BANDGAP,		/**< Internal 0.9 V band gap reference */
+} CMP_INPUT_T;
+
+/** Comparator output edges */
+typedef enum CHIP_CMP_EDGE {
+	CMP_EDGE_FALLING = 0,	/**< Falling edge of the output */
+	CMP_EDGE_RISING,		/**< Rising edge of the output */
+	CMP_EDGE_BOTH,			/**< Both edges of the output */
+} CMP_EDGE_T;
+
+/**
+ * @brief	Initialize the comparators
+ * @param	pCMP	: The base of the comparator peripheral on the chip
+ * @return	Nothing
+ * @note	Powers up and resets the comparator block, both comparators
+ *			and the voltage ladder are disabled.
+ */
+void Chip_CMP_Init(LPC_CMP_T *pCMP);
+
+/**
+ * @brief	Shutdown the comparators
+ * @param	pCMP	: The base of the comparator peripheral on the chip
+ * @return	Nothing
+ */
+void Chip_CMP_DeInit(LPC_CMP_T *pCMP);
+
+/**
+ * @brief	Enable a comparator
+ * @param	pCMP	: The base of the comparator peripheral on the chip
+ * @param	id		: Comparator
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_CMP_Enable(LPC_CMP_T *pCMP, CMP_ID_T id)
+{
+	pCMP->CMP = (pCMP->CMP & ~CMP_INT_MASK) | CMP_EN(id);
+}
+
+/**
+ * @brief	Disable a comparator
+ * @param	pCMP	: The base of the comparator peripheral on the chip
+ * @param	id		: Comparator
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_CMP_Disable(LPC_CMP_T *pCMP, CMP_ID_T id)
+{
+	pCMP->CMP &= ~(CMP_INT_MASK | CMP_EN(id));
+}
+
+/**
+ * @brief	Read a comparator output
+ * @param	pCMP	: The base of the comparator peripheral on the chip
+ * @param	id		: Comparator
+ * @return	true if the positive input is above the negative input
+ */
+STATIC INLINE bool Chip_CMP_GetOutput(LPC_CMP_T *pCMP, CMP_ID_T id)
+{
+	return (pCMP->CMP & CMP_STAT(id)) != 0;
+}
+
+/**
+ * @brief	Check if a comparator output edge was detected
+ * @param	pCMP	: The base of the comparator peripheral on the chip
+ * @param	id		: Comparator
+ * @return	true if the edge selected with Chip_CMP_SetIntEdge() occurred
+ */
+STATIC INLINE bool Chip_CMP_GetIntStatus(LPC_CMP_T *pCMP, CMP_ID_T id)
+{
+	return (pCMP->CMP & CMP_INT(id)) != 0;
+}
+
+/**
+ * @brief	Clear the edge detected flag of a comparator
+ * @param	pCMP	: The base of the comparator peripheral on the chip
+ * @param	id		: Comparator
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_CMP_ClearIntStatus(LPC_CMP_T *pCMP, CMP_ID_T id)
+{
+	pCMP->CMP = (pCMP->CMP & ~CMP_INT_MASK) | CMP_INT(id);
+}
+
+/**
+ * @brief	Select the inputs of a comparator
+ * @param	pCMP	: The base of the comparator peripheral on the chip
+ * @param	id		: Comparator
+ * @param	vp		: Positive input
+ * @param	vm		: Negative input
+ * @return	Nothing
+ */
+void Chip_CMP_SetInputs(LPC_CMP_T *pCMP, CMP_ID_T id, CMP_INPUT_T vp, CMP_INPUT_T vm);
+
+/**
+ * @brief	Set up and enable the voltage ladder
+ * @param	pCMP	: The base of the comparator peripheral on the chip
+ * @param	step	: Ladder output, @a step / 31 of the reference (0 to 31)
+ * @param	vddcmp	: true to use the VDDCMP pin as reference, false for VDD(3V3)
+ * @return	Nothing
+ * @note	The ladder is shared by both comparators
+ */
+void Chip_CMP_SetupLadder(LPC_CMP_T *pCMP, uint8_t step, bool vddcmp);
+
+/**
+ * @brief	Disable the voltage ladder
+ * @param	pCMP	: The base of the comparator peripheral on the chip
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_CMP_DisableLadder(LPC_CMP_T *pCMP)
+{
+	pCMP->VLAD &= ~CMP_VLAD_EN;
+}
+
+/**
+ * @brief	Enable or disable the hysteresis of a comparator
+ * @param	pCMP	: The base of the comparator peripheral on the chip
+ * @param	id		: Comparator
+ * @param	enable	: true to enable the hysteresis
+ * @return	Nothing
+ */
+void Chip_CMP_SetHysteresis(LPC_CMP_T *pCMP, CMP_ID_T id, bool enable);
+
+/**
+ * @brief	Enable or disable the synchronization of a comparator output
+ * @param	pCMP	: The base of the comparator peripheral on the chip
+ * @param	id		: Comparator
+ * @param	enable	: true to synchronize the output with the bus clock
+ * @return	Nothing
+ */
+void Chip_CMP_SetSync(LPC_CMP_T *pCMP, CMP_ID_T id, bool enable);
+
+/**
+ * @brief	Select the output edges setting the edge detected flag
+ * @param	pCMP	: The base of the comparator peripheral on the chip
+ * @param	id		: Comparator
+ * @param	edge	: Edges of the output
+ * @return	Nothing
+ * @note	The flag raises the comparator interrupt (COMP_IRQn) and is
+ *			cleared with Chip_CMP_ClearIntStatus(). A comparator trip
+ *			can be posted to an ADC watchdog with Chip_ADC_WatchdogTrip().
+ */
+void Chip_CMP_SetIntEdge(LPC_CMP_T *pCMP, CMP_ID_T id, CMP_EDGE_T edge);
+
+/**
+ * @brief	Capture the timer count on comparator output edges
+ * @param	pCMP	: The base of the comparator peripheral on the chip
+ * @param	id		: Comparator
+ * @param	pTimer	: Timer with a capture input driven by the comparator output
+ * @param	capnum	: Capture input of @a pTimer driven by the comparator output
+ * @param	edge	: Edges of the output loading the capture register
+ * @param	prescale: Timer count rate is the bus clock / @a prescale
+ * @return	Nothing
+ * @note
+ * The comparator output is synchronized with the bus clock and the timer
+ * is started free running, with an interrupt on each capture. The
+ * capture registers then hold the time of the zero crossings with no
+ * software involved, see Chip_CMP_CapturePeriod(). The comparator output
+ * reaches the capture input through the ACMPn_O pin function, the pins
+ * must be set up with Chip_IOCON_PinMuxSet().
+ */
+void Chip_CMP_SetupCapture(LPC_CMP_T *pCMP, CMP_ID_T id, LPC_TIMER_T *pTimer, int8_t capnum,
+						   CMP_EDGE_T edge, uint32_t prescale);
+
+/**
+ * @brief	Get the time between the last two captures
+ * @param	pTimer	: Timer passed to Chip_CMP_SetupCapture()
+ * @param	capnum	: Capture input passed to Chip_CMP_SetupCapture()
+ * @param	last	: Previous capture value, updated with the current one
+ * @return	Timer counts since the previous capture, modulo the timer width
+ * @note	Call once per capture, usually from the timer interrupt
+ */
+uint32_t Chip_CMP_CapturePeriod(LPC_TIMER_T *pTimer, int8_t capnum, uint32_t *last);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CMP_122X_H_ */
@@ -0,0 +1,327 @@
+/*
+ * @brief LPC122x CRC engine chip driver
+ *
+ * @note
+ * WARNING: THIS LIBRARY HAS BEEN PORTED TO LPC122x devices from the lpc_chip_11u14 LPCOPEN chip library. Please consider this when using it.
+ * This library is provided as is, and the authors DO NOT GUARANTEE that it is working.
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2012
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __CRC_122X_H_
+#define __CRC_122X_H_
+
+#include "lpc_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup CRC_122X CHIP: LPC122x CRC engine driver
+ * @ingroup CHIP_122X_Drivers
+ * The CRC engine shifts each written item in most significant byte
+ * first. Chip_CRC_Update() feeds a byte stream, so it gives the same
+ * result for any alignment and split of the data. The Chip_CRC_SW*
+ * functions compute the same CRCs in software with small tables and do
+ * not need the hardware, they can be built for a host.
+ * @{
+ */
+
+/**
+ * @brief CRC polynomials
+ */
+typedef enum IP_CRC_001_POLY {
+	CRC_POLY_CCITT = 0,			/**< CRC-CCITT polynomial, x^16 + x^12 + x^5 + 1 */
+	CRC_POLY_CRC16 = 1,			/**< CRC-16 polynomial, x^16 + x^15 + x^2 + 1 */
+	CRC_POLY_CRC32 = 2,			/**< CRC-32 polynomial, x^32 + x^26 + ... + x + 1 */
+	CRC_POLY_LAST,
+} CRC_POLY_T;
+
+/**
+ * @brief CRC MODE register bit definitions
+ */
+#define CRC_MODE_POLY_BITMASK   ((0x03))		/*!< CRC polynomial select */
+#define CRC_MODE_WRDATA_BIT_RVS (1 << 2)		/*!< Bit order reverse of each written byte */
+#define CRC_MODE_WRDATA_CMPL    (1 << 3)		/*!< One's complement of the written data */
+#define CRC_MODE_SUM_BIT_RVS    (1 << 4)		/*!< Bit order reverse of the checksum */
+#define CRC_MODE_SUM_CMPL       (1 << 5)		/*!< One's complement of the checksum */
+
+/** Default MODE and SEED values, CRC-16/CCITT-FALSE, CRC-16/ARC and the usual CRC-32 */
+#define MODE_CFG_CCITT          (0x00)
+#define MODE_CFG_CRC16          (CRC_MODE_WRDATA_BIT_RVS | CRC_MODE_SUM_BIT_RVS)
+#define MODE_CFG_CRC32          (CRC_MODE_WRDATA_BIT_RVS | CRC_MODE_SUM_BIT_RVS | CRC_MODE_SUM_CMPL)
+#define CRC_SEED_CCITT          (0x0000FFFF)
+#define CRC_SEED_CRC16          (0x00000000)
+#define CRC_SEED_CRC32          (0xFFFFFFFF)
+
+/**
+ * @brief Software CRC state
+ */
+typedef struct {
+	uint32_t mode;		/*!< MODE register equivalent, polynomial and options */
+	uint32_t sum;		/*!< Shift register, before the checksum options */
+} CRC_SW_T;
+
+/**
+ * @brief	Start a software CRC
+ * @param	crc		: State to set up
+ * @param	poly	: Polynomial
+ * @param	flags	: OR'ed CRC_MODE_* options
+ * @param	seed	: Initial value of the shift register
+ * @return	Nothing
+ */
+void Chip_CRC_SWInit(CRC_SW_T *crc, CRC_POLY_T poly, uint32_t flags, uint32_t seed);
+
+/**
+ * @brief	Start a software CRC with the default setup of a polynomial
+ * @param	crc		: State to set up
+ * @param	poly	: Polynomial, with the MODE_CFG_* and CRC_SEED_* setup
+ * @return	Nothing
+ */
+void Chip_CRC_SWDefault(CRC_SW_T *crc, CRC_POLY_T poly);
+
+/**
+ * @brief	Feed bytes to a software CRC
+ * @param	crc		: State
+ * @param	data	: Bytes to feed
+ * @param	bytes	: Number of bytes
+ * @return	Nothing
+ * @note	Same result as Chip_CRC_Update() with the same setup
+ */
+void Chip_CRC_SWUpdate(CRC_SW_T *crc, const void *data, uint32_t bytes);
+
+/**
+ * @brief	Get the checksum of a software CRC
+ * @param	crc		: State
+ * @return	Checksum, with the CRC_MODE_SUM_* options applied
+ * @note	Feeding can go on after this call
+ */
+uint32_t Chip_CRC_SWSum(const CRC_SW_T *crc);
+
+#if defined(CORE_M0)
+/**
+ * @brief CRC register block structure
+ */
+typedef struct {					/*!< CRC Structure */
+	__IO    uint32_t    MODE;		/*!< CRC Mode Register */
+	__IO    uint32_t    SEED;		/*!< CRC SEED Register */
+	union {
+		__I     uint32_t    SUM;		/*!< CRC Checksum Register. */
+		__O     uint32_t    WRDATA32;	/*!< CRC Data Register: write size 32-bit*/
+		__O     uint16_t    WRDATA16;	/*!< CRC Data Register: write size 16-bit*/
+		__O     uint8_t     WRDATA8;	/*!< CRC Data Register: write size 8-bit*/
+	};
+} LPC_CRC_T;
+
+/** DMA channel used by Chip_CRC_UpdateDMA(), a software request channel by default */
+#ifndef CRC_DMA_CHANNEL
+#define CRC_DMA_CHANNEL         DMA_CH_SW0
+#endif
+
+/**
+ * @brief CRC DMA callback, called from the DMA interrupt handler
+ */
+typedef void (*CRC_DMA_CALLBACK_T)(Status status);
+
+/**
+ * @brief	Initialize the CRC engine
+ * @return	Nothing
+ */
+void Chip_CRC_Init(void);
+
+/**
+ * @brief	Shutdown the CRC engine
+ * @return	Nothing
+ */
+void Chip_CRC_DeInit(void);
+
+/**
+ * @brief	Select the polynomial and options
+ * @param	poly	: Polynomial
+ * @param	flags	: OR'ed CRC_MODE_* options
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_CRC_SetPoly(CRC_POLY_T poly, uint32_t flags)
+{
+	LPC_CRC->MODE = (uint32_t) poly | flags;
+}
+
+/**
+ * @brief	Select a polynomial with its default options and seed
+ * @param	poly	: Polynomial, with the MODE_CFG_* and CRC_SEED_* setup
+ * @return	Nothing
+ */
+void Chip_CRC_UseDefaultConfig(CRC_POLY_T poly);
+
+/**
+ * @brief	Set the MODE register
+ * @param	mode	: Polynomial OR'ed with CRC_MODE_* options
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_CRC_SetMode(uint32_t mode)
+{
+	LPC_CRC->MODE = mode;
+}
+
+/**
+ * @brief	Get the MODE register
+ * @return	Polynomial OR'ed with CRC_MODE_* options
+ */
+STATIC INLINE uint32_t Chip_CRC_GetMode(void)
+{
+	return LPC_CRC->MODE;
+}
+
+/**
+ * @brief	Set the seed, restarting the CRC
+ * @param	seed	: Initial value of the shift register
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_CRC_SetSeed(uint32_t seed)
+{
+	LPC_CRC->SEED = seed;
+}
+
+/**
+ * @brief	Get the seed
+ * @return	Seed value
+ */
+STATIC INLINE uint32_t Chip_CRC_GetSeed(void)
+{
+	return LPC_CRC->SEED;
+}
+
+/**
+ * @brief	Feed a byte
+ * @param	data	: Byte
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_CRC_Write8(uint8_t data)
+{
+	LPC_CRC->WRDATA8 = data;
+}
+
+/**
+ * @brief	Feed a halfword, most significant byte first
+ * @param	data	: Halfword
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_CRC_Write16(uint16_t data)
+{
+	LPC_CRC->WRDATA16 = data;
+}
+
+/**
+ * @brief	Feed a word, most significant byte first
+ * @param	data	: Word
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_CRC_Write32(uint32_t data)
+{
+	LPC_CRC->WRDATA32 = data;
+}
+
+/**
+ * @brief	Get the checksum
+ * @return	Checksum, with the CRC_MODE_SUM_* options applied
+ */
+STATIC INLINE uint32_t Chip_CRC_Sum(void)
+{
+	return LPC_CRC->SUM;
+}
+
+/**
+ * @brief	Feed a byte stream
+ * @param	data	: Bytes to feed
+ * @param	bytes	: Number of bytes
+ * @return	Nothing
+ * @note	Unaligned head and tail bytes are written one by one and the
+ *			aligned middle a word at a time, byte swapped so that the
+ *			engine sees the bytes in memory order. Several calls continue
+ *			the same CRC.
+ */
+void Chip_CRC_Update(const void *data, uint32_t bytes);
+
+/**
+ * @brief	Feed a byte stream with DMA (non-blocking)
+ * @param	data	: Bytes to feed, must stay valid until the callback
+ * @param	bytes	: Number of bytes
+ * @param	callback: Called with SUCCESS once all bytes are fed, or ERROR on a bus error; may be NULL
+ * @return	ERROR if a DMA feed is in progress, SUCCESS otherwise
+ * @note
+ * The DMA controller must have been initialized with Chip_DMA_Init() and
+ * Chip_DMA_IRQHandler() must be called from DMA_IRQHandler(). The bytes
+ * are written one by one by #CRC_DMA_CHANNEL in cycles of DMA_MAX_XFER,
+ * so the result is the same as with Chip_CRC_Update(). The CRC engine
+ * must not be used otherwise until the callback.
+ */
+Status Chip_CRC_UpdateDMA(const void *data, uint32_t bytes, CRC_DMA_CALLBACK_T callback);
+
+/**
+ * @brief	Check if a DMA feed is in progress
+ * @return	true if Chip_CRC_UpdateDMA() bytes are still being fed
+ */
+bool Chip_CRC_IsDMABusy(void);
+
+/**
+ * @brief	CRC of a byte block with the current polynomial and options
+ * @param	data	: Bytes
+ * @param	bytes	: Number of bytes
+ * @return	Checksum
+ * @note	The seed is reloaded before the block
+ */
+uint32_t Chip_CRC_CRC8(const uint8_t *data, uint32_t bytes);
+
+/**
+ * @brief	CRC of a halfword block with the current polynomial and options
+ * @param	data	: Halfwords, each fed most significant byte first
+ * @param	hwords	: Number of halfwords
+ * @return	Checksum
+ * @note	The seed is reloaded before the block
+ */
+uint32_t Chip_CRC_CRC16(const uint16_t *data, uint32_t hwords);
+
+/**
+ * @brief	CRC of a word block with the current polynomial and options
+ * @param	data	: Words, each fed most significant byte first
+ * @param	words	: Number of words
+ * @return	Checksum
+ * @note	The seed is reloaded before the block
+ */
+uint32_t Chip_CRC_CRC32(const uint32_t *data, uint32_t words);
+#endif /* defined(CORE_M0) */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CRC_122X_H_ */
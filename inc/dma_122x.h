@@ -0,0 +1,453 @@
+/*
+ * @brief LPC122x micro DMA (PL230) chip driver
+ *
+ * @note
+ * WARNING: THIS LIBRARY HAS BEEN PORTED TO LPC122x devices from the lpc_chip_11u14 LPCOPEN chip library. Please consider this when using it.
+ * This library is provided as is, and the authors DO NOT GUARANTEE that it is working.
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2012
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __DMA_122X_H_
+#define __DMA_122X_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup DMA_122X CHIP: LPC122x micro DMA driver
+ * @ingroup CHIP_122X_Drivers
+ * The LPC122x micro DMA controller is an ARM PL230. Each channel is driven by
+ * a primary and an alternate control descriptor held in a RAM table that the
+ * driver owns (see Chip_DMA_GetDesc()). The table is aligned as required by
+ * the controller for its channel count.
+ * @{
+ */
+
+/**
+ * @brief micro DMA register block structure
+ */
+typedef struct {					/*!< DMA Structure          */
+	__I  uint32_t  STATUS;			/*!< Offset: 0x000 DMA status register (R/ ) */
+	__O  uint32_t  CFG;				/*!< Offset: 0x004 DMA configuration register ( /W) */
+	__IO uint32_t  CTRL_BASE_PTR;	/*!< Offset: 0x008 Channel control base pointer register (R/W) */
+	__I  uint32_t  ALT_CTRL_BASE_PTR;	/*!< Offset: 0x00C Alternate channel control base pointer register (R/ ) */
+	__I  uint32_t  WAITONREQ_STATUS;	/*!< Offset: 0x010 Channel wait on request status register (R/ ) */
+	__O  uint32_t  CHNL_SW_REQUEST;	/*!< Offset: 0x014 Channel software request register ( /W) */
+	__IO uint32_t  CHNL_USEBURST_SET;	/*!< Offset: 0x018 Channel useburst set register (R/W) */
+	__O  uint32_t  CHNL_USEBURST_CLR;	/*!< Offset: 0x01C Channel useburst clear register ( /W) */
+	__IO uint32_t  CHNL_REQ_MASK_SET;	/*!< Offset: 0x020 Channel request mask set register (R/W) */
+	__O  uint32_t  CHNL_REQ_MASK_CLR;	/*!< Offset: 0x024 Channel request mask clear register ( /W) */
+	__IO uint32_t  CHNL_ENABLE_SET;	/*!< Offset: 0x028 Channel enable set register (R/W) */
+	__O  uint32_t  CHNL_ENABLE_CLR;	/*!< Offset: 0x02C Channel enable clear register ( /W) */
+	__IO uint32_t  CHNL_PRI_ALT_SET;	/*!< Offset: 0x030 Channel primary-alternate set register (R/W) */
+	__O  uint32_t  CHNL_PRI_ALT_CLR;	/*!< Offset: 0x034 Channel primary-alternate clear register ( /W) */
+	__IO uint32_t  CHNL_PRIORITY_SET;	/*!< Offset: 0x038 Channel priority set register (R/W) */
+	__O  uint32_t  CHNL_PRIORITY_CLR;	/*!< Offset: 0x03C Channel priority clear register ( /W) */
+	__I  uint32_t  RESERVED0[3];
+	__IO uint32_t  ERR_CLR;			/*!< Offset: 0x04C Bus error clear register (R/W) */
+	__I  uint32_t  RESERVED1[12];
+	__IO uint32_t  CHNL_IRQ_STATUS;	/*!< Offset: 0x080 Channel DMA interrupt status register (R/W) */
+	__IO uint32_t  IRQ_ERR_ENABLE;	/*!< Offset: 0x084 DMA error interrupt enable register (R/W) */
+	__IO uint32_t  CHNL_IRQ_ENABLE;	/*!< Offset: 0x088 Channel DMA interrupt enable register (R/W) */
+} LPC_DMA_T;
+
+/**
+ * @brief DMA configuration register definitions
+ */
+#define DMA_CFG_MASTER_EN       (1 << 0)	/*!< Enable the controller */
+
+/**
+ * @brief DMA status register definitions
+ */
+#define DMA_STATUS_MASTER_EN    (1 << 0)	/*!< Controller is enabled */
+#define DMA_STATUS_STATE_MASK   (0x0F << 4)	/*!< Current state of the control state machine */
+#define DMA_STATUS_STATE_IDLE   (0x00 << 4)	/*!< Control state machine is idle */
+
+/**
+ * @brief DMA channel and peripheral request mapping
+ */
+typedef enum {
+	DMA_CH_UART0_TX = 0,		/*!< UART0 transmit */
+	DMA_CH_UART0_RX,			/*!< UART0 receive */
+	DMA_CH_UART1_TX,			/*!< UART1 transmit */
+	DMA_CH_UART1_RX,			/*!< UART1 receive */
+	DMA_CH_SSP0_TX,				/*!< SSP0 transmit */
+	DMA_CH_SSP0_RX,				/*!< SSP0 receive */
+	DMA_CH_ADC,					/*!< ADC conversion done */
+	DMA_CH_RTC,					/*!< RTC match */
+	DMA_CH_CT32B0_MAT0,			/*!< 32-bit timer 0 match 0 */
+	DMA_CH_CT32B0_MAT1,			/*!< 32-bit timer 0 match 1 */
+	DMA_CH_CT32B1_MAT0,			/*!< 32-bit timer 1 match 0 */
+	DMA_CH_CT32B1_MAT1,			/*!< 32-bit timer 1 match 1 */
+	DMA_CH_CT16B0_MAT0,			/*!< 16-bit timer 0 match 0 */
+	DMA_CH_CT16B1_MAT0,			/*!< 16-bit timer 1 match 0 */
+	DMA_CH_CMP0,				/*!< Comparator 0 output */
+	DMA_CH_CMP1,				/*!< Comparator 1 output */
+	DMA_CH_PIO0,				/*!< PIO0 interrupt */
+	DMA_CH_PIO1,				/*!< PIO1 interrupt */
+	DMA_CH_PIO2,				/*!< PIO2 interrupt */
+	DMA_CH_SW0,					/*!< Software request only */
+	DMA_CH_SW1					/*!< Software request only */
+} DMA_CHID_T;
+
+#define DMA_CHANNEL_NUM         (21)	/*!< Number of DMA channels */
+#define DMA_TABLE_ENTRIES       (32)	/*!< Number of descriptors in each of the primary and alternate tables */
+#define DMA_TABLE_ALIGN         (1024)	/*!< Alignment of the descriptor table required by the controller */
+#define DMA_MAX_XFER            (1024)	/*!< Maximum number of transfers in one DMA cycle */
+
+/**
+ * @brief DMA channel control descriptor
+ */
+typedef struct {
+	volatile uint32_t  srcEnd;		/*!< Address of the last source item */
+	volatile uint32_t  dstEnd;		/*!< Address of the last destination item */
+	volatile uint32_t  ctrl;		/*!< Channel control word, updated by the controller */
+	uint32_t  reload;				/*!< Unused by the controller, holds the control word used to re-arm the descriptor */
+} DMA_CHDESC_T;
+
+/**
+ * @brief DMA channel control word definitions
+ */
+#define DMA_CTRL_CYCLE_STOP         (0 << 0)	/*!< Descriptor is invalid / cycle completed */
+#define DMA_CTRL_CYCLE_BASIC        (1 << 0)	/*!< Basic cycle, one request per arbitration */
+#define DMA_CTRL_CYCLE_AUTO         (2 << 0)	/*!< Auto-request cycle, a single request completes the cycle */
+#define DMA_CTRL_CYCLE_PINGPONG     (3 << 0)	/*!< Ping-pong cycle */
+#define DMA_CTRL_CYCLE_MEM_SG_PRI   (4 << 0)	/*!< Memory scatter-gather, primary descriptor */
+#define DMA_CTRL_CYCLE_MEM_SG_ALT   (5 << 0)	/*!< Memory scatter-gather, alternate descriptor */
+#define DMA_CTRL_CYCLE_PER_SG_PRI   (6 << 0)	/*!< Peripheral scatter-gather, primary descriptor */
+#define DMA_CTRL_CYCLE_PER_SG_ALT   (7 << 0)	/*!< Peripheral scatter-gather, alternate descriptor */
+#define DMA_CTRL_CYCLE_MASK         (7 << 0)	/*!< Cycle control mask */
+#define DMA_CTRL_NEXT_USEBURST      (1 << 3)	/*!< Set the channel useburst bit at the end of a scatter-gather cycle */
+#define DMA_CTRL_N_MINUS_1(n)       ((((n) - 1) & 0x3FF) << 4)	/*!< Number of transfers in the cycle */
+#define DMA_CTRL_N_MINUS_1_MASK     (0x3FF << 4)	/*!< Number of transfers mask */
+#define DMA_CTRL_GET_COUNT(ctrl)    (((((ctrl) >> 4) & 0x3FF) + 1))	/*!< Transfers left in a descriptor, valid while its cycle is not STOP */
+#define DMA_CTRL_R_POWER(p)         (((p) & 0x0F) << 14)	/*!< Arbitrate after 2^p transfers */
+#define DMA_CTRL_SRC_SIZE_8         (0 << 24)	/*!< Source data is a byte */
+#define DMA_CTRL_SRC_SIZE_16        (1 << 24)	/*!< Source data is a halfword */
+#define DMA_CTRL_SRC_SIZE_32        (2 << 24)	/*!< Source data is a word */
+#define DMA_CTRL_SRC_INC_8          (0 << 26)	/*!< Source address increment is a byte */
+#define DMA_CTRL_SRC_INC_16         (1 << 26)	/*!< Source address increment is a halfword */
+#define DMA_CTRL_SRC_INC_32         (2 << 26)	/*!< Source address increment is a word */
+#define DMA_CTRL_SRC_INC_NONE       (3 << 26)	/*!< Source address is fixed (peripheral register) */
+#define DMA_CTRL_DST_SIZE_8         (0 << 28)	/*!< Destination data is a byte */
+#define DMA_CTRL_DST_SIZE_16        (1 << 28)	/*!< Destination data is a halfword */
+#define DMA_CTRL_DST_SIZE_32        (2 << 28)	/*!< Destination data is a word */
+#define DMA_CTRL_DST_INC_8          (0 << 30)	/*!< Destination address increment is a byte */
+#define DMA_CTRL_DST_INC_16         (1 << 30)	/*!< Destination address increment is a halfword */
+#define DMA_CTRL_DST_INC_32         (2 << 30)	/*!< Destination address increment is a word */
+#define DMA_CTRL_DST_INC_NONE       (3UL << 30)	/*!< Destination address is fixed (peripheral register) */
+
+/** Memory to peripheral byte transfers, R_power 0 */
+#define DMA_XFER_MEM2PER_8      (DMA_CTRL_SRC_SIZE_8 | DMA_CTRL_SRC_INC_8 | DMA_CTRL_DST_SIZE_8 | DMA_CTRL_DST_INC_NONE)
+/** Peripheral to memory byte transfers, R_power 0 */
+#define DMA_XFER_PER2MEM_8      (DMA_CTRL_SRC_SIZE_8 | DMA_CTRL_SRC_INC_NONE | DMA_CTRL_DST_SIZE_8 | DMA_CTRL_DST_INC_8)
+/** Peripheral to memory halfword transfers, R_power 0 */
+#define DMA_XFER_PER2MEM_16     (DMA_CTRL_SRC_SIZE_16 | DMA_CTRL_SRC_INC_NONE | DMA_CTRL_DST_SIZE_16 | DMA_CTRL_DST_INC_16)
+/** Memory to memory word transfers, arbitrating every 4 words */
+#define DMA_XFER_MEM2MEM_32     (DMA_CTRL_SRC_SIZE_32 | DMA_CTRL_SRC_INC_32 | DMA_CTRL_DST_SIZE_32 | DMA_CTRL_DST_INC_32 | DMA_CTRL_R_POWER(2))
+
+/**
+ * @brief DMA channel events passed to the channel callback
+ */
+typedef enum {
+	DMA_EVENT_PRI_DONE,			/*!< Primary descriptor cycle completed */
+	DMA_EVENT_ALT_DONE,			/*!< Alternate descriptor cycle completed */
+	DMA_EVENT_ERROR				/*!< Bus error, the channel has been disabled */
+} DMA_EVENT_T;
+
+/**
+ * @brief DMA channel callback, called from Chip_DMA_IRQHandler()
+ */
+typedef void (*DMA_CALLBACK_T)(DMA_CHID_T ch, DMA_EVENT_T event);
+
+/**
+ * @brief	Initialize the DMA controller
+ * @param	pDMA	: The base address of the DMA controller
+ * @return	Nothing
+ * @note	Enables the DMA clock and calls Chip_DMA_Setup().
+ */
+void Chip_DMA_Init(LPC_DMA_T *pDMA);
+
+/**
+ * @brief	Set up the DMA controller registers and the descriptor table
+ * @param	pDMA	: The base address of the DMA controller
+ * @return	Nothing
+ * @note	Points the controller at the driver's descriptor table, clears
+ * all channel state and enables the master. The DMA clock must already be
+ * enabled. Only @a pDMA is accessed, so the driver can be run against a
+ * register block in RAM.
+ */
+void Chip_DMA_Setup(LPC_DMA_T *pDMA);
+
+/**
+ * @brief	De-initialize the DMA controller
+ * @param	pDMA	: The base address of the DMA controller
+ * @return	Nothing
+ */
+void Chip_DMA_DeInit(LPC_DMA_T *pDMA);
+
+/**
+ * @brief	Get a channel descriptor
+ * @param	ch		: DMA channel
+ * @param	alt		: true for the alternate descriptor, false for the primary
+ * @return	Pointer to the descriptor in the driver's control table
+ */
+DMA_CHDESC_T *Chip_DMA_GetDesc(DMA_CHID_T ch, bool alt);
+
+/**
+ * @brief	Fill in a channel descriptor
+ * @param	pDesc	: Descriptor to fill in
+ * @param	ctrl	: OR'ed DMA_CTRL_CYCLE_*, DMA_CTRL_SRC_*, DMA_CTRL_DST_* and DMA_CTRL_R_POWER() values
+ * @param	src		: Source start address
+ * @param	dst		: Destination start address
+ * @param	count	: Number of transfers, 1 to DMA_MAX_XFER
+ * @return	ERROR if count is out of range, SUCCESS otherwise
+ * @note	The end pointers are computed from the start addresses and the
+ * increment settings. The control word is also saved in the descriptor so
+ * that it can be re-armed with Chip_DMA_ReloadDesc().
+ */
+Status Chip_DMA_SetupDesc(DMA_CHDESC_T *pDesc, uint32_t ctrl, const volatile void *src,
+						  volatile void *dst, uint32_t count);
+
+/**
+ * @brief	Re-arm a completed descriptor with its original control word
+ * @param	pDesc	: Descriptor set up with Chip_DMA_SetupDesc()
+ * @return	Nothing
+ * @note	Use this from the callback of a ping-pong channel to hand the
+ * completed half back to the controller.
+ */
+STATIC INLINE void Chip_DMA_ReloadDesc(DMA_CHDESC_T *pDesc)
+{
+	pDesc->ctrl = pDesc->reload;
+}
+
+/**
+ * @brief	Get the number of transfers not yet done by a descriptor
+ * @param	pDesc	: Descriptor to check
+ * @return	Number of transfers remaining, 0 if the cycle has completed
+ */
+STATIC INLINE uint32_t Chip_DMA_GetDescRemaining(const DMA_CHDESC_T *pDesc)
+{
+	uint32_t ctrl = pDesc->ctrl;
+
+	if ((ctrl & DMA_CTRL_CYCLE_MASK) == DMA_CTRL_CYCLE_STOP) {
+		return 0;
+	}
+	return DMA_CTRL_GET_COUNT(ctrl);
+}
+
+/**
+ * @brief	Register the completion callback of a channel
+ * @param	ch			: DMA channel
+ * @param	callback	: Function called from Chip_DMA_IRQHandler(), or NULL for none
+ * @return	Nothing
+ */
+void Chip_DMA_SetCallback(DMA_CHID_T ch, DMA_CALLBACK_T callback);
+
+/**
+ * @brief	Start a basic or auto-request transfer on a channel
+ * @param	pDMA	: The base address of the DMA controller
+ * @param	ch		: DMA channel
+ * @param	ctrl	: DMA_CTRL_CYCLE_BASIC for peripheral requests, DMA_CTRL_CYCLE_AUTO
+ *					  for memory to memory, OR'ed with the DMA_CTRL_SRC_* / DMA_CTRL_DST_* settings
+ * @param	src		: Source start address
+ * @param	dst		: Destination start address
+ * @param	count	: Number of transfers, 1 to DMA_MAX_XFER
+ * @return	ERROR if count is out of range, SUCCESS otherwise
+ * @note	Auto-request transfers are kicked off with a software request.
+ * DMA_EVENT_PRI_DONE is reported when the transfer completes.
+ */
+Status Chip_DMA_Transfer(LPC_DMA_T *pDMA, DMA_CHID_T ch, uint32_t ctrl, const volatile void *src,
+						 volatile void *dst, uint32_t count);
+
+/**
+ * @brief	Start a ping-pong transfer on a channel
+ * @param	pDMA	: The base address of the DMA controller
+ * @param	ch		: DMA channel
+ * @param	ctrl	: OR'ed DMA_CTRL_SRC_* / DMA_CTRL_DST_* settings
+ * @param	src		: Source start addresses, [0] for primary and [1] for alternate
+ * @param	dst		: Destination start addresses, [0] for primary and [1] for alternate
+ * @param	count	: Number of transfers of each half, 1 to DMA_MAX_XFER
+ * @return	ERROR if count is out of range, SUCCESS otherwise
+ * @note	The callback gets DMA_EVENT_PRI_DONE or DMA_EVENT_ALT_DONE each time
+ * a half completes and must re-arm that half with Chip_DMA_ReloadDesc() (after
+ * optionally changing its addresses) before the other half completes.
+ */
+Status Chip_DMA_PingPong(LPC_DMA_T *pDMA, DMA_CHID_T ch, uint32_t ctrl, const volatile void *const src[2],
+						 volatile void *const dst[2], uint32_t count);
+
+/**
+ * @brief	Start a scatter-gather transfer on a channel
+ * @param	pDMA	: The base address of the DMA controller
+ * @param	ch		: DMA channel
+ * @param	pTasks	: Task list, each entry set up with Chip_DMA_SetupDesc(), must be word aligned
+ * @param	numTasks: Number of tasks in the list, 1 to DMA_MAX_XFER / 4
+ * @param	periph	: true for peripheral scatter-gather, false for memory scatter-gather
+ * @return	ERROR if numTasks is out of range, SUCCESS otherwise
+ * @note	The cycle type of each task is set by this function: all but the
+ * last task are chained in scatter-gather mode, the last one is a basic
+ * (peripheral) or auto-request (memory) cycle. DMA_EVENT_PRI_DONE is reported
+ * once the last task completes.
+ */
+Status Chip_DMA_ScatterGather(LPC_DMA_T *pDMA, DMA_CHID_T ch, DMA_CHDESC_T *pTasks,
+							  uint32_t numTasks, bool periph);
+
+/**
+ * @brief	Stop a channel
+ * @param	pDMA	: The base address of the DMA controller
+ * @param	ch		: DMA channel
+ * @return	Nothing
+ * @note	The channel interrupt is disabled and no callback will be called.
+ */
+void Chip_DMA_Abort(LPC_DMA_T *pDMA, DMA_CHID_T ch);
+
+/**
+ * @brief	Enable a DMA channel
+ * @param	pDMA	: The base address of the DMA controller
+ * @param	ch		: DMA channel
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_DMA_EnableChannel(LPC_DMA_T *pDMA, DMA_CHID_T ch)
+{
+	pDMA->CHNL_ENABLE_SET = (1 << ch);
+}
+
+/**
+ * @brief	Disable a DMA channel
+ * @param	pDMA	: The base address of the DMA controller
+ * @param	ch		: DMA channel
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_DMA_DisableChannel(LPC_DMA_T *pDMA, DMA_CHID_T ch)
+{
+	pDMA->CHNL_ENABLE_CLR = (1 << ch);
+}
+
+/**
+ * @brief	Check if a DMA channel is enabled
+ * @param	pDMA	: The base address of the DMA controller
+ * @param	ch		: DMA channel
+ * @return	true if the channel is enabled, false once its cycle completed or it was disabled
+ */
+STATIC INLINE bool Chip_DMA_IsChannelEnabled(LPC_DMA_T *pDMA, DMA_CHID_T ch)
+{
+	return (bool) ((pDMA->CHNL_ENABLE_SET & (1 << ch)) != 0);
+}
+
+/**
+ * @brief	Issue a software DMA request on a channel
+ * @param	pDMA	: The base address of the DMA controller
+ * @param	ch		: DMA channel
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_DMA_SWTrigger(LPC_DMA_T *pDMA, DMA_CHID_T ch)
+{
+	pDMA->CHNL_SW_REQUEST = (1 << ch);
+}
+
+/**
+ * @brief	Check if the alternate descriptor of a channel is the active one
+ * @param	pDMA	: The base address of the DMA controller
+ * @param	ch		: DMA channel
+ * @return	true if the alternate descriptor is in use, false for the primary
+ */
+STATIC INLINE bool Chip_DMA_IsAltActive(LPC_DMA_T *pDMA, DMA_CHID_T ch)
+{
+	return (bool) ((pDMA->CHNL_PRI_ALT_SET & (1 << ch)) != 0);
+}
+
+/**
+ * @brief	Set the priority of a DMA channel
+ * @param	pDMA	: The base address of the DMA controller
+ * @param	ch		: DMA channel
+ * @param	high	: true for high priority, false for default priority
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_DMA_SetHighPriority(LPC_DMA_T *pDMA, DMA_CHID_T ch, bool high)
+{
+	if (high) {
+		pDMA->CHNL_PRIORITY_SET = (1 << ch);
+	}
+	else {
+		pDMA->CHNL_PRIORITY_CLR = (1 << ch);
+	}
+}
+
+/**
+ * @brief	Set the useburst state of a DMA channel
+ * @param	pDMA	: The base address of the DMA controller
+ * @param	ch		: DMA channel
+ * @param	burst	: true to respond to burst requests only, false for single and burst requests
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_DMA_SetUseBurst(LPC_DMA_T *pDMA, DMA_CHID_T ch, bool burst)
+{
+	if (burst) {
+		pDMA->CHNL_USEBURST_SET = (1 << ch);
+	}
+	else {
+		pDMA->CHNL_USEBURST_CLR = (1 << ch);
+	}
+}
+
+/**
+ * @brief	Mask or unmask the peripheral requests of a DMA channel
+ * @param	pDMA	: The base address of the DMA controller
+ * @param	ch		: DMA channel
+ * @param	mask	: true to ignore peripheral requests, false to accept them
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_DMA_MaskRequest(LPC_DMA_T *pDMA, DMA_CHID_T ch, bool mask)
+{
+	if (mask) {
+		pDMA->CHNL_REQ_MASK_SET = (1 << ch);
+	}
+	else {
+		pDMA->CHNL_REQ_MASK_CLR = (1 << ch);
+	}
+}
+
+/**
+ * @brief	DMA interrupt handler
+ * @param	pDMA	: The base address of the DMA controller
+ * @return	Nothing
+ * @note	Call this from the application's DMA_IRQHandler(). It clears the
+ * completion and error flags and dispatches the channel callbacks.
+ */
+void Chip_DMA_IRQHandler(LPC_DMA_T *pDMA);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DMA_122X_H_ */
@@ -258,8 +258,40 @@ typedef enum {
 	I2C_STATUS_ARBLOST,	/**< Aribitration lost during transfer */
 	I2C_STATUS_BUSERR,	/**< Bus error in I2C transfer */
 	I2C_STATUS_BUSY,	/**< I2C is busy doing transfer */
+	I2C_STATUS_TIMEOUT,	/**< Transfer aborted by the timeout, the bus was recovered */
 } I2C_STATUS_T;
 
+/**
+ * @brief	I2C bus recovery pins, the I2C pins used as GPIO
+ * @note	Define these before including chip.h when the I2C pins or their
+ * GPIO function differ from the defaults
+ */
+#ifndef I2C_SCL_IOCON
+#define I2C_SCL_IOCON       IOCON_PIO0_10	/**< IOCON pin of SCL */
+#define I2C_SDA_IOCON       IOCON_PIO0_11	/**< IOCON pin of SDA */
+#define I2C_GPIO_PORT       0				/**< GPIO port of SCL and SDA */
+#define I2C_SCL_GPIO_PIN    10				/**< GPIO pin of SCL */
+#define I2C_SDA_GPIO_PIN    11				/**< GPIO pin of SDA */
+#define I2C_GPIO_FUNC       IOCON_FUNC0		/**< IOCON function selecting GPIO on both pins */
+#endif
+
+#define I2C_RETRY_DEFAULT       3		/**< Default number of retries of the blocking master functions */
+#define I2C_BACKOFF_DEFAULT     100		/**< Default delay before the first retry, in microseconds */
+
+/**
+ * @brief Master message segment structure definitions
+ */
+typedef struct {
+	uint8_t slaveAddr;		/**< 7-bit I2C Slave address of the segment */
+	uint8_t flags;			/**< OR'ed I2C_MSG_* flags */
+	uint16_t len;			/**< Number of bytes to transfer, must not be 0 */
+	uint8_t *buf;			/**< Data to send or memory for the received data */
+} I2C_MSG_T;
+
+#define I2C_MSG_RD          (1 << 0)	/**< Read segment, write otherwise */
+#define I2C_MSG_NOSTART     (1 << 1)	/**< Write segment continues the previous write without a repeated START */
+#define I2C_MSG_NOSTOP      (1 << 2)	/**< Last segment only: keep the bus, the next transfer starts with a repeated START */
+
 /**
  * @brief Master transfer data structure definitions
  */
@@ -272,8 +304,12 @@ typedef struct {
 	int     rxSz;			/**< Number of bytes to received,
 							   if 0 only transmission we be carried on */
 	I2C_STATUS_T status;	/**< Status of the current I2C transfer */
+	const I2C_MSG_T *msgs;	/**< Current message segment, set by Chip_I2C_SetupMsgXfer(), cleared for a plain transfer */
+	int     numMsgs;		/**< Number of message segments left, including the current one */
 } I2C_XFER_T;
 
+#define I2C_XFER_MSGS       0xFF	/**< @a slaveAddr of a transfer set up by Chip_I2C_SetupMsgXfer() */
+
 /**
  * @brief	I2C interface IDs
  * @note
@@ -304,6 +340,67 @@ typedef enum {
  */
 typedef void (*I2C_EVENTHANDLER_T)(I2C_ID_T, I2C_EVENT_T);
 
+/**
+ * @brief	Asynchronous master transfer job
+ */
+typedef struct I2C_JOB I2C_JOB_T;
+
+/**
+ * @brief	Asynchronous master transfer completion callback, called from the I2C interrupt
+ */
+typedef void (*I2C_JOBCALLBACK_T)(I2C_ID_T, I2C_JOB_T *);
+
+/**
+ * @brief	Asynchronous master transfer job structure
+ */
+struct I2C_JOB {
+	I2C_XFER_T xfer;			/**< Transfer to do, see Chip_I2C_MasterTransfer() */
+	I2C_JOBCALLBACK_T callback;	/**< Called once the transfer is done, may be NULL */
+	void *data;					/**< Application data, not used by the driver */
+	I2C_JOB_T *next;			/**< Used by the driver */
+};
+
+#define I2C_REG_MAX_SIZE    8		/**< Maximum size of a register file register in bytes */
+#define I2C_REG_RO          (1 << 0)	/**< Register is read-only for the master */
+
+/**
+ * @brief	Register file register
+ */
+typedef struct I2C_REG I2C_REG_T;
+
+/**
+ * @brief	Register commit callback, called from the I2C interrupt once the
+ * master has written a register
+ */
+typedef void (*I2C_REGCALLBACK_T)(I2C_ID_T, const I2C_REG_T *);
+
+/**
+ * @brief	Register file register structure
+ */
+struct I2C_REG {
+	uint8_t addr;				/**< Register address of the first byte */
+	uint8_t size;				/**< Size in bytes, 1 to #I2C_REG_MAX_SIZE */
+	uint8_t flags;				/**< OR'ed I2C_REG_* flags */
+	uint8_t *data;				/**< Register value, first byte at @a addr */
+	const uint8_t *wrMask;		/**< Bits the master may write, one mask per byte, NULL for all */
+	I2C_REGCALLBACK_T commit;	/**< Called once the master has written the register, may be NULL */
+};
+
+/**
+ * @brief	Register file slave structure
+ */
+typedef struct {
+	uint8_t slaveAddr;			/**< 7-bit slave address from Bit1 to Bit7, see Chip_I2C_SlaveSetup() */
+	const I2C_REG_T *regs;		/**< Register table, registers must not overlap */
+	int numRegs;				/**< Number of registers in the table */
+	I2C_XFER_T xfer;			/**< Used by the driver */
+	const I2C_REG_T *cur;		/**< Used by the driver */
+	uint8_t ptr;				/**< Used by the driver */
+	uint8_t state;				/**< Used by the driver */
+	uint8_t written;			/**< Used by the driver */
+	uint8_t buf[I2C_REG_MAX_SIZE];	/**< Used by the driver */
+} I2C_REGFILE_T;
+
 /**
  * @brief	Initializes the LPC_I2C peripheral with specified parameter.
  * @param	id			: I2C peripheral ID (I2C0, I2C1 ... etc)
@@ -327,14 +424,69 @@ void Chip_I2C_DeInit(I2C_ID_T id);
  * Parameter @a clockrate for I2C0 should be from 1000 up to 1000000
  * (1 KHz to 1 MHz), as I2C0 support Fast Mode Plus. If the @a clockrate
  * is more than 400 KHz (Fast Plus Mode) Board_I2C_EnableFastPlus()
- * must be called prior to calling this function.
+ * must be called prior to calling this function. The bus mode is picked
+ * from @a clockrate and no rise time is assumed, so the rate on the bus is
+ * not above @a clockrate, see Chip_I2C_SetClockRateMode().
  */
 void Chip_I2C_SetClockRate(I2C_ID_T id, uint32_t clockrate);
 
+/**
+ * @brief	I2C bus modes
+ */
+typedef enum {
+	I2C_BUS_STANDARD,	/**< Standard-mode, up to 100 KHz */
+	I2C_BUS_FAST,		/**< Fast-mode, up to 400 KHz */
+	I2C_BUS_FASTPLUS,	/**< Fast-mode Plus, up to 1 MHz */
+} I2C_BUSMODE_T;
+
+/**
+ * @brief	I2C SCL timing setup
+ */
+typedef struct {
+	uint16_t sclh;			/**< SCLH value */
+	uint16_t scll;			/**< SCLL value */
+	uint32_t clockrate;		/**< Achieved SCL rate in Hz, rise time included */
+} I2C_CLOCK_T;
+
+/**
+ * @brief	Find the SCLH and SCLL values for a bus mode and rate
+ * @param	clkin		: I2C peripheral clock rate, the system clock
+ * @param	mode		: Bus mode, sets the minimum SCL low and high times
+ * @param	clockrate	: Target SCL rate in Hz, limited to the maximum of @a mode
+ * @param	riseNs		: Measured SCL rise time in ns, 0 for no rise time compensation
+ * @param	pClk		: Pointer to the setup to fill
+ * @return	ERROR if @a clockrate can not be reached with 16-bit counts or is
+ *			used up by the rise time, SUCCESS otherwise
+ * @note
+ * The SCL high count only starts once SCL is seen high, so the period is
+ * (SCLH + SCLL) clocks plus the rise time. The counts are the smallest
+ * that give a rate not above @a clockrate. Without a rise time the period
+ * is (SCLH + SCLL) clocks, which any rise time only makes longer. SCLL and SCLH are at least the
+ * tLOW and tHIGH minimums of @a mode, the remaining clocks are shared in
+ * the same ratio. If the minimums do not fit the period the achieved
+ * rate is lower than @a clockrate. This function does not access the
+ * hardware.
+ */
+Status Chip_I2C_CalcClock(uint32_t clkin, I2C_BUSMODE_T mode, uint32_t clockrate, uint32_t riseNs,
+						  I2C_CLOCK_T *pClk);
+
+/**
+ * @brief	Set up a compliant SCL timing for a bus mode
+ * @param	id			: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @param	mode		: Bus mode, see Chip_I2C_CalcClock()
+ * @param	clockrate	: Target SCL rate in Hz
+ * @param	riseNs		: Measured SCL rise time in ns, see Chip_I2C_CalcClock()
+ * @return	Achieved SCL rate in Hz, 0 if no timing was found and nothing was changed
+ * @note	For #I2C_BUS_FASTPLUS the pins must be set up for Fast-mode Plus
+ * first, see Chip_I2C_SetClockRate()
+ */
+uint32_t Chip_I2C_SetClockRateMode(I2C_ID_T id, I2C_BUSMODE_T mode, uint32_t clockrate, uint32_t riseNs);
+
 /**
  * @brief	Get current clock rate for LPC_I2C peripheral.
  * @param	id			: I2C peripheral ID (I2C0, I2C1 ... etc)
  * @return	The current I2C peripheral clock rate
+ * @note	The SCL rise time is not included
  */
 uint32_t Chip_I2C_GetClockRate(I2C_ID_T id);
 
@@ -380,6 +532,84 @@ int Chip_I2C_MasterSend(I2C_ID_T id, uint8_t slaveAddr, const uint8_t *buff, uin
  */
 int Chip_I2C_MasterCmdRead(I2C_ID_T id, uint8_t slaveAddr, uint8_t cmd, uint8_t *buff, int len);
 
+/**
+ * @brief	Set up a transfer from an array of message segments
+ * @param	xfer	: Pointer to the transfer to set up
+ * @param	msgs	: Array of message segments, must stay valid during the transfer
+ * @param	num		: Number of message segments
+ * @return	Nothing
+ * @note
+ * The segments are run back to back while the master owns the bus, each
+ * one starting with a repeated START and its own address and direction,
+ * unless it is a write flagged #I2C_MSG_NOSTART following a write. A STOP
+ * is only sent after the last segment, or on error, unless the last
+ * segment is flagged #I2C_MSG_NOSTOP. The set up @a xfer can be passed to
+ * Chip_I2C_MasterTransfer() or queued as an asynchronous job. On return
+ * of the transfer @a xfer->msgs points to the segment that ended it.
+ * @a xfer->slaveAddr is set to #I2C_XFER_MSGS to select the segments, a
+ * transfer with a plain slave address ignores @a msgs and @a numMsgs, so
+ * existing code does not need to initialize them. Set up @a xfer again
+ * before each transfer.
+ */
+void Chip_I2C_SetupMsgXfer(I2C_XFER_T *xfer, I2C_MSG_T *msgs, int num);
+
+/**
+ * @brief	Transfer an array of message segments in master mode
+ * @param	id		: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @param	msgs	: Array of message segments
+ * @param	num		: Number of message segments
+ * @return	Any of #I2C_STATUS_T values
+ * @note	See Chip_I2C_SetupMsgXfer()
+ */
+int Chip_I2C_MasterTransferMsgs(I2C_ID_T id, I2C_MSG_T *msgs, int num);
+
+/**
+ * @brief	Read a block from slave registers after writing the register address
+ * @param	id			: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @param	slaveAddr	: Slave address of the I2C device
+ * @param	reg			: Register address, sent MSB first
+ * @param	regSz		: Size of the register address, 1 or 2 bytes
+ * @param	buff		: Pointer to memory that will hold the data received
+ * @param	len			: Number of bytes to receive
+ * @return	@a len on success, 0 on error
+ */
+int Chip_I2C_MasterReadReg(I2C_ID_T id, uint8_t slaveAddr, uint16_t reg, int regSz, uint8_t *buff, int len);
+
+/**
+ * @brief	Write a block to slave registers, register address and data in one write
+ * @param	id			: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @param	slaveAddr	: Slave address of the I2C device
+ * @param	reg			: Register address, sent MSB first
+ * @param	regSz		: Size of the register address, 1 or 2 bytes
+ * @param	buff		: Pointer to the data to write
+ * @param	len			: Number of bytes to write
+ * @return	@a len on success, 0 on error
+ */
+int Chip_I2C_MasterWriteReg(I2C_ID_T id, uint8_t slaveAddr, uint16_t reg, int regSz, const uint8_t *buff, int len);
+
+/**
+ * @brief	Queue an asynchronous transfer in master mode
+ * @param	id		: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @param	job		: Pointer to the job, must stay valid until its callback is called
+ * @return	Nothing
+ * @note
+ * Returns immediately, the job is run from Chip_I2C_MasterStateHandler()
+ * in the I2C interrupt once the jobs queued before it are done. Back to
+ * back jobs are chained with a repeated START, the bus is only released
+ * with a STOP when the queue runs empty or a job fails. On completion
+ * @a job->xfer.status holds the #I2C_STATUS_T result and the callback is
+ * called from the interrupt; it may queue further jobs. Do not mix with
+ * the blocking master functions while jobs are queued.
+ */
+void Chip_I2C_MasterSubmit(I2C_ID_T id, I2C_JOB_T *job);
+
+/**
+ * @brief	Check if asynchronous master transfers are queued
+ * @param	id		: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @return	1 if a job is queued or in progress, 0 otherwise
+ */
+int Chip_I2C_MasterJobsPending(I2C_ID_T id);
+
 /**
  * @brief	Get pointer to current function handling the events
  * @param	id			: I2C peripheral ID (I2C0, I2C1 ... etc)
@@ -447,6 +677,58 @@ void Chip_I2C_Disable(I2C_ID_T id);
  */
 int Chip_I2C_IsMasterActive(I2C_ID_T id);
 
+/**
+ * @brief	Set up the master transfer timeout
+ * @param	id			: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @param	pTimer		: Timer used for the timeout, NULL to disable the timeout
+ * @param	timeoutUs	: Maximum time a transfer may take, in microseconds
+ * @return	ERROR if the timeout does not fit the timer, SUCCESS otherwise
+ * @note
+ * The timer is owned by the driver and restarted for every transfer. A
+ * transfer still busy when it expires, a bus held low or a slave
+ * stretching the clock for too long, is aborted with #I2C_STATUS_TIMEOUT
+ * and the bus is recovered with Chip_I2C_RecoverBus(). Blocking transfers
+ * poll the timer, asynchronous jobs need Chip_I2C_TimeoutHandler() to be
+ * called from the timer interrupt handler.
+ */
+Status Chip_I2C_SetTimeout(I2C_ID_T id, LPC_TIMER_T *pTimer, uint32_t timeoutUs);
+
+/**
+ * @brief	Master transfer timeout handler
+ * @param	id		: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @return	Nothing
+ * @note	Usually called from the interrupt handler of the timer set up
+ * with Chip_I2C_SetTimeout(), does nothing if the timeout has not expired
+ */
+void Chip_I2C_TimeoutHandler(I2C_ID_T id);
+
+/**
+ * @brief	Free a bus held low by a slave
+ * @param	id		: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @return	SUCCESS if both SCL and SDA are high afterwards, ERROR otherwise
+ * @note
+ * Disables the I2C and muxes the I2C pins to GPIO, then clocks SCL up to
+ * 9 times until the slave releases SDA and sends a STOP condition. The
+ * I2C pin configuration is restored, the I2C is left disabled until the
+ * next master transfer or Chip_I2C_SlaveSetup().
+ */
+Status Chip_I2C_RecoverBus(I2C_ID_T id);
+
+/**
+ * @brief	Set the retry policy of the blocking master functions
+ * @param	id			: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @param	retries		: Number of retries after the first attempt, 0 for none
+ * @param	backoffUs	: Delay before the first retry in microseconds, doubled for every retry
+ * @return	Nothing
+ * @note
+ * Chip_I2C_MasterSend(), Chip_I2C_MasterCmdRead(), Chip_I2C_MasterRead(),
+ * Chip_I2C_MasterReadReg() and Chip_I2C_MasterWriteReg() retry after an
+ * arbitration loss, a bus error or a timeout, the bus is recovered before
+ * retrying after a bus error. A NAK is not retried. Defaults are
+ * #I2C_RETRY_DEFAULT and #I2C_BACKOFF_DEFAULT.
+ */
+void Chip_I2C_SetRetry(I2C_ID_T id, int retries, uint32_t backoffUs);
+
 /**
  * @brief	Setup a slave I2C device
  * @param	id			: I2C peripheral ID (I2C0, I2C1 ... etc)
@@ -521,6 +803,48 @@ void Chip_I2C_SlaveSetup(I2C_ID_T id,
  */
 void Chip_I2C_SlaveStateHandler(I2C_ID_T id);
 
+/**
+ * @brief	Setup a register file slave
+ * @param	id			: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @param	sid			: I2C Slave peripheral ID (I2C_SLAVE_0, I2C_SLAVE_1 etc)
+ * @param	regFile		: Pointer to the register file, must stay valid while the slave is active
+ * @param	addrMask	: Address mask to use along with slave address, see Chip_I2C_SlaveSetup()
+ * @return	ERROR if a register is empty or larger than #I2C_REG_MAX_SIZE, SUCCESS otherwise
+ * @note
+ * The slave is served entirely from Chip_I2C_SlaveStateHandler(), no
+ * events are raised. The first byte the master writes sets the register
+ * pointer, which auto-increments on every byte read or written. A read
+ * of a register returns a copy taken when the pointer enters it, so
+ * that a multi-byte value is always consistent. Bytes written by the
+ * master are collected and only stored, masked by @a wrMask, when every
+ * byte of the register has been written, followed by its commit callback.
+ * Partial writes, including writes that start inside a register, are
+ * dropped. Unmapped addresses read as 0xFF and ignore
+ * writes. Registers must be updated and read by the application with
+ * Chip_I2C_RegUpdate() and Chip_I2C_RegRead().
+ */
+Status Chip_I2C_SlaveRegSetup(I2C_ID_T id, I2C_SLAVE_ID sid, I2C_REGFILE_T *regFile, uint8_t addrMask);
+
+/**
+ * @brief	Update the value of a register file register
+ * @param	id		: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @param	reg		: Register to update
+ * @param	value	: New value, @a reg->size bytes
+ * @return	Nothing
+ * @note	The I2C interrupt is masked during the copy
+ */
+void Chip_I2C_RegUpdate(I2C_ID_T id, const I2C_REG_T *reg, const void *value);
+
+/**
+ * @brief	Read the value of a register file register
+ * @param	id		: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @param	reg		: Register to read
+ * @param	value	: Memory for the value, @a reg->size bytes
+ * @return	Nothing
+ * @note	The I2C interrupt is masked during the copy
+ */
+void Chip_I2C_RegRead(I2C_ID_T id, const I2C_REG_T *reg, void *value);
+
 /**
  * @brief	I2C peripheral state change checking
  * @param	id		: I2C peripheral ID (I2C0, I2C1 ... etc)
@@ -33,12 +33,33 @@
 #define __RING_BUFFER_H_
 
 #include "lpc_types.h"
+#if defined(CORE_M0)
+#include "cmsis.h"
+#endif
 
 /** @defgroup Ring_Buffer CHIP: Simple ring buffer implementation
  * @ingroup CHIP_Common
+ * The ring buffer is safe for single-producer/single-consumer (SPSC) use
+ * without masking interrupts: the producer (RingBuffer_Insert*) only ever
+ * writes the head index and the consumer (RingBuffer_Pop*) only ever writes
+ * the tail index. Item data is ordered against the index updates with a
+ * data memory barrier, so one side may run in an ISR and the other in
+ * thread context. Calls on the same side from more than one context, or
+ * RingBuffer_Flush() while the other side is active, still need the caller
+ * to provide mutual exclusion.
  * @{
  */
 
+/**
+ * @def		RB_MEMBARRIER()
+ * Data memory barrier used to order item accesses against index updates
+ */
+#if defined(CORE_M0)
+#define RB_MEMBARRIER()           __DMB()
+#else
+#define RB_MEMBARRIER()           __sync_synchronize()
+#endif
+
 /**
  * @brief Ring buffer structure
  */
@@ -50,6 +71,14 @@ typedef struct {
 	uint32_t tail;
 } RINGBUFF_T;
 
+/**
+ * @brief Contiguous span of items inside the ring buffer storage
+ */
+typedef struct {
+	void *data;		/*!< Pointer to the first item of the span */
+	int count;		/*!< Number of items in the span */
+} RINGBUFF_SPAN_T;
+
 /**
  * @def		RB_VHEAD(rb)
  * volatile typecasted head index
@@ -79,6 +108,8 @@ int RingBuffer_Init(RINGBUFF_T *RingBuff, void *buffer, int itemSize, int count)
  * @brief	Resets the ring buffer to empty
  * @param	RingBuff	: Pointer to ring buffer
  * @return	Nothing
+ * @note	This writes both indexes and must not run while the producer
+ *			or the consumer side is active in another context.
  */
 STATIC INLINE void RingBuffer_Flush(RINGBUFF_T *RingBuff)
 {
@@ -146,6 +177,47 @@ STATIC INLINE int RingBuffer_IsEmpty(RINGBUFF_T *RingBuff)
  */
 int RingBuffer_Insert(RINGBUFF_T *RingBuff, const void *data);
 
+/**
+ * @brief	Insert a single byte into a byte ring buffer of a fixed size
+ * @param	RingBuff	: Pointer to ring buffer
+ * @param	data		: Byte to insert
+ * @param	count		: Size of the ring buffer, as passed to RingBuffer_Init()
+ * @return	1 when successfully inserted, 0 when the buffer is full
+ * @note	When @a count is a compile-time constant the index mask is folded
+ *			into the code and the insert is a single store plus the head
+ *			increment. Passing a size that differs from the initialized one
+ *			corrupts the ring buffer.
+ */
+STATIC INLINE int RingBuffer_InsertByteN(RINGBUFF_T *RingBuff, uint8_t data, const int count)
+{
+	uint32_t head = RingBuff->head;
+
+	if ((head - RB_VTAIL(RingBuff)) >= (uint32_t) count)
+		return 0;
+
+	RB_MEMBARRIER();
+	((uint8_t *) RingBuff->data)[head & (count - 1)] = data;
+	RB_MEMBARRIER();
+	RB_VHEAD(RingBuff) = head + 1;
+
+	return 1;
+}
+
+/**
+ * @brief	Insert a single byte into a byte ring buffer
+ * @param	RingBuff	: Pointer to ring buffer
+ * @param	data		: Byte to insert
+ * @return	1 when successfully inserted, 0 when the buffer is full
+ * @note	Inline variant of RingBuffer_Insert() for ring buffers initialized
+ *			with an item size of 1. The byte is stored directly, without the
+ *			item size multiply and memcpy() of the generic path, which makes
+ *			it suitable for per-character interrupt handlers.
+ */
+STATIC INLINE int RingBuffer_InsertByte(RINGBUFF_T *RingBuff, uint8_t data)
+{
+	return RingBuffer_InsertByteN(RingBuff, data, RingBuff->count);
+}
+
 /**
  * @brief	Insert an array of items into ring buffer
  * @param	RingBuff	: Pointer to ring buffer
@@ -169,6 +241,42 @@ int RingBuffer_InsertMult(RINGBUFF_T *RingBuff, const void *data, int num);
  */
 int RingBuffer_Pop(RINGBUFF_T *RingBuff, void *data);
 
+/**
+ * @brief	Pop a single byte from a byte ring buffer of a fixed size
+ * @param	RingBuff	: Pointer to ring buffer
+ * @param	data		: Pointer to memory where popped byte be stored
+ * @param	count		: Size of the ring buffer, as passed to RingBuffer_Init()
+ * @return	1 when a byte was popped onto @a data, 0 when the buffer is empty
+ * @note	See RingBuffer_InsertByteN() for the use of @a count.
+ */
+STATIC INLINE int RingBuffer_PopByteN(RINGBUFF_T *RingBuff, uint8_t *data, const int count)
+{
+	uint32_t tail = RingBuff->tail;
+
+	if (RB_VHEAD(RingBuff) == tail)
+		return 0;
+
+	RB_MEMBARRIER();
+	*data = ((uint8_t *) RingBuff->data)[tail & (count - 1)];
+	RB_MEMBARRIER();
+	RB_VTAIL(RingBuff) = tail + 1;
+
+	return 1;
+}
+
+/**
+ * @brief	Pop a single byte from a byte ring buffer
+ * @param	RingBuff	: Pointer to ring buffer
+ * @param	data		: Pointer to memory where popped byte be stored
+ * @return	1 when a byte was popped onto @a data, 0 when the buffer is empty
+ * @note	Inline variant of RingBuffer_Pop() for ring buffers initialized
+ *			with an item size of 1.
+ */
+STATIC INLINE int RingBuffer_PopByte(RINGBUFF_T *RingBuff, uint8_t *data)
+{
+	return RingBuffer_PopByteN(RingBuff, data, RingBuff->count);
+}
+
 /**
  * @brief	Pop an array of items from the ring buffer
  * @param	RingBuff	: Pointer to ring buffer
@@ -180,6 +288,48 @@ int RingBuffer_Pop(RINGBUFF_T *RingBuff, void *data);
  */
 int RingBuffer_PopMult(RINGBUFF_T *RingBuff, void *data, int num);
 
+/**
+ * @brief	Get the free space of the ring buffer for in-place writing
+ * @param	RingBuff	: Pointer to ring buffer
+ * @param	span		: Array of 2 spans to fill, span[0] starts at the
+ *						  head and span[1] is the part wrapped to the start
+ *						  of the buffer (count is 0 if not wrapped)
+ * @return	Total number of free items in both spans
+ * @note	The producer writes items directly into the returned spans and
+ *			then makes them visible with RingBuffer_CommitWrite(). Nothing
+ *			is copied and the ring buffer is not changed by this call.
+ */
+int RingBuffer_ReserveWrite(RINGBUFF_T *RingBuff, RINGBUFF_SPAN_T span[2]);
+
+/**
+ * @brief	Commit items written in place after RingBuffer_ReserveWrite()
+ * @param	RingBuff	: Pointer to ring buffer
+ * @param	num			: Number of items written, starting at span[0]
+ * @return	Number of items committed, limited to the free space
+ */
+int RingBuffer_CommitWrite(RINGBUFF_T *RingBuff, int num);
+
+/**
+ * @brief	Get the pending items of the ring buffer for in-place reading
+ * @param	RingBuff	: Pointer to ring buffer
+ * @param	span		: Array of 2 spans to fill, span[0] starts at the
+ *						  tail and span[1] is the part wrapped to the start
+ *						  of the buffer (count is 0 if not wrapped)
+ * @return	Total number of items in both spans
+ * @note	The consumer reads items directly from the returned spans and
+ *			then releases them with RingBuffer_ConsumeRead(). Nothing is
+ *			copied and the ring buffer is not changed by this call.
+ */
+int RingBuffer_PeekRead(RINGBUFF_T *RingBuff, RINGBUFF_SPAN_T span[2]);
+
+/**
+ * @brief	Release items read in place after RingBuffer_PeekRead()
+ * @param	RingBuff	: Pointer to ring buffer
+ * @param	num			: Number of items consumed, starting at span[0]
+ * @return	Number of items released, limited to the pending count
+ */
+int RingBuffer_ConsumeRead(RINGBUFF_T *RingBuff, int num);
+
 
 /**
  * @}
@@ -0,0 +1,225 @@
+/*
+ * @brief SPI NOR flash driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2012
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __SPI_NOR_H_
+#define __SPI_NOR_H_
+
+#include "lpc_types.h"
+#if defined(CORE_M0)
+#include "chip.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup SPI_NOR CHIP: SPI NOR flash driver
+ * @ingroup CHIP_Common
+ * Driver for serial NOR flash devices with 3 byte addresses (up to
+ * 16 MB). The geometry is read from the SFDP basic parameter table when
+ * the device has one, and guessed from the JEDEC ID otherwise. The bus
+ * is reached through a SPINOR_BUS_T, SpiNor_InitSSP() binds it to an SSP
+ * with a GPIO chip select. Any other bus, such as a flash simulator on a
+ * host build, can be used with SpiNor_Init().
+ * @{
+ */
+
+/**
+ * @brief SPI NOR bus interface
+ */
+typedef struct {
+	/** Assert (true) or release (false) the chip select */
+	void (*select)(void *bus, bool assert);
+	/** Full-duplex transfer of @a len bytes, @a tx NULL sends 0xFF and
+	    @a rx NULL drops the received bytes. Returns SUCCESS or ERROR. */
+	Status (*transfer)(void *bus, const uint8_t *tx, uint8_t *rx, uint32_t len);
+} SPINOR_BUS_T;
+
+/** Maximum number of erase types, as in the SFDP basic parameter table */
+#define SPINOR_ERASE_TYPES      4
+
+/**
+ * @brief SPI NOR erase type
+ */
+typedef struct {
+	uint8_t opcode;		/*!< Erase opcode */
+	uint8_t shift;		/*!< Erase size is 1 << shift bytes, 0 if not supported */
+} SPINOR_ERASE_T;
+
+/**
+ * @brief SPI NOR device structure
+ */
+typedef struct {
+	const SPINOR_BUS_T *bus;	/*!< Bus interface */
+	void *busData;				/*!< Passed to the bus interface */
+	uint32_t jedecId;			/*!< Manufacturer, type and capacity bytes */
+	uint32_t size;				/*!< Device size in bytes */
+	uint32_t pageSize;			/*!< Program page size in bytes */
+	SPINOR_ERASE_T erase[SPINOR_ERASE_TYPES];	/*!< Erase types, largest first */
+	bool sfdp;					/*!< Geometry read from SFDP */
+} SPINOR_T;
+
+/**
+ * @brief Page program data source
+ * @param	arg		: Argument given to SpiNor_ProgramFill()
+ * @param	buf		: Buffer to fill
+ * @param	offset	: Offset of @a buf from the start of the programmed area
+ * @param	len		: Number of bytes to fill
+ */
+typedef void (*SPINOR_FILL_T)(void *arg, uint8_t *buf, uint32_t offset, uint32_t len);
+
+/** Command set */
+#define SPINOR_CMD_PP           0x02	/*!< Page program */
+#define SPINOR_CMD_RDSR         0x05	/*!< Read status register */
+#define SPINOR_CMD_WREN         0x06	/*!< Write enable */
+#define SPINOR_CMD_FAST_READ    0x0B	/*!< Read with 8 dummy clocks */
+#define SPINOR_CMD_SE           0x20	/*!< 4 KB sector erase */
+#define SPINOR_CMD_SFDP         0x5A	/*!< Read SFDP, with 8 dummy clocks */
+#define SPINOR_CMD_RDID         0x9F	/*!< Read JEDEC ID */
+#define SPINOR_CMD_BE           0xD8	/*!< 64 KB block erase */
+
+/** Status register bits */
+#define SPINOR_SR_WIP           (1 << 0)	/*!< Write in progress */
+#define SPINOR_SR_WEL           (1 << 1)	/*!< Write enable latch */
+
+/** Number of status reads before a program or erase is given up */
+#ifndef SPINOR_POLL_MAX
+#define SPINOR_POLL_MAX         0x01000000
+#endif
+
+/**
+ * @brief	Detect a SPI NOR device
+ * @param	flash	: Pointer to the device structure to set up
+ * @param	bus		: Bus interface
+ * @param	busData	: Passed to the bus interface
+ * @return	ERROR if no device answers the JEDEC ID command or the device
+ *			is not supported, SUCCESS otherwise
+ * @note	The JEDEC ID is read first, then the SFDP basic parameter
+ *			table. Without SFDP the size is taken from the JEDEC capacity
+ *			byte, with 256 byte pages and 4 KB / 64 KB erase.
+ */
+Status SpiNor_Init(SPINOR_T *flash, const SPINOR_BUS_T *bus, void *busData);
+
+/**
+ * @brief	Read from the device
+ * @param	flash	: Pointer to the device
+ * @param	addr	: Device address
+ * @param	buf		: Buffer to read into
+ * @param	len		: Number of bytes to read
+ * @return	ERROR on a bus error or if the range is past the end of the device, SUCCESS otherwise
+ * @note	Uses a single fast read (0x0B) command, the data is streamed
+ *			by the bus directly into @a buf.
+ */
+Status SpiNor_Read(SPINOR_T *flash, uint32_t addr, void *buf, uint32_t len);
+
+/**
+ * @brief	Program the device from a buffer
+ * @param	flash	: Pointer to the device
+ * @param	addr	: Device address
+ * @param	data	: Data to program
+ * @param	len		: Number of bytes to program
+ * @return	ERROR on a bus error, timeout or if the range is past the end of the device, SUCCESS otherwise
+ * @note	The area must have been erased. The data is split on page
+ *			boundaries and each page is sent straight from @a data.
+ */
+Status SpiNor_Program(SPINOR_T *flash, uint32_t addr, const void *data, uint32_t len);
+
+/**
+ * @brief	Program the device from a data source
+ * @param	flash	: Pointer to the device
+ * @param	addr	: Device address
+ * @param	len		: Number of bytes to program
+ * @param	fill	: Called to prepare the data of each page
+ * @param	arg		: Passed to @a fill
+ * @param	pageBuf	: Buffer of at least @a flash->pageSize bytes
+ * @return	ERROR on a bus error, timeout or if the range is past the end of the device, SUCCESS otherwise
+ * @note	The next page is prepared by @a fill while the device is busy
+ *			programming the current one, so the preparation time is
+ *			hidden behind the page program time.
+ */
+Status SpiNor_ProgramFill(SPINOR_T *flash, uint32_t addr, uint32_t len,
+						  SPINOR_FILL_T fill, void *arg, uint8_t *pageBuf);
+
+/**
+ * @brief	Erase an area of the device
+ * @param	flash	: Pointer to the device
+ * @param	addr	: Start address, aligned to the smallest erase size
+ * @param	len		: Number of bytes, a multiple of the smallest erase size
+ * @return	ERROR on a bus error, timeout or a misaligned or out of range area, SUCCESS otherwise
+ * @note	Each step uses the largest erase type that is aligned at the
+ *			current address and fits in the remaining length.
+ */
+Status SpiNor_Erase(SPINOR_T *flash, uint32_t addr, uint32_t len);
+
+/**
+ * @brief	Get the smallest erase size
+ * @param	flash	: Pointer to the device
+ * @return	Smallest erase size in bytes
+ */
+uint32_t SpiNor_GetEraseSize(SPINOR_T *flash);
+
+/**
+ * @brief	Wait until a program or erase is done
+ * @param	flash	: Pointer to the device
+ * @return	ERROR on a bus error or after #SPINOR_POLL_MAX status reads, SUCCESS otherwise
+ */
+Status SpiNor_WaitReady(SPINOR_T *flash);
+
+#if defined(CORE_M0)
+/**
+ * @brief SSP bus binding
+ */
+typedef struct {
+	LPC_SSP_T *pSSP;		/*!< SSP, set up as master with 8 bit frames in SPI mode 0 or 3 */
+	SPI_Address_t cs;		/*!< GPIO chip select, active low */
+} SPINOR_SSP_T;
+
+/**
+ * @brief	Detect a SPI NOR device on an SSP
+ * @param	flash	: Pointer to the device structure to set up
+ * @param	ssp		: SSP binding, must stay valid while the device is used
+ * @return	See SpiNor_Init()
+ * @note	The chip select pin is set up as a GPIO output driven high. The
+ *			SSP transfers use the blocking functions, which keep the SSP
+ *			FIFO full.
+ */
+Status SpiNor_InitSSP(SPINOR_T *flash, SPINOR_SSP_T *ssp);
+#endif
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SPI_NOR_H_ */
@@ -58,6 +58,7 @@ typedef struct {			/*!< SSPn Structure         */
 	__I  uint32_t RIS;		/*!< Raw Interrupt Status Register */
 	__I  uint32_t MIS;		/*!< Masked Interrupt Status Register */
 	__O  uint32_t ICR;		/*!< SSPICR Interrupt Clear Register */
+	__IO uint32_t DMACR;	/*!< SSPDMACR DMA Control Register */
 } LPC_SSP_T;
 
 /**
@@ -127,6 +128,15 @@ typedef struct {			/*!< SSPn Structure         */
 /** ICR bit mask */
 #define SSP_ICR_BITMASK ((uint32_t) (0x03))
 
+/**
+ * Macro defines for DMACR register
+ */
+
+/** SSP receive DMA enable */
+#define SSP_DMA_RXDMAE  ((uint32_t) (1 << 0))
+/** SSP transmit DMA enable */
+#define SSP_DMA_TXDMAE  ((uint32_t) (1 << 1))
+
 /**
  * @brief SSP Type of Status
  */
@@ -471,6 +481,51 @@ typedef struct {
 #define SSP_SLAVE_MODE          SSP_CR1_SLAVE_EN
 #define SSP_MASTER_MODE         SSP_CR1_MASTER_EN
 
+/** Depth of the SSP transmit and receive FIFOs in frames */
+#define SSP_FIFO_DEPTH          8
+
+/*
+ * @brief SSP job status
+ */
+typedef enum CHIP_SSP_JOB_STATUS {
+	SSP_JOB_DONE,		/**< Job done successfully */
+	SSP_JOB_OVERRUN,	/**< Receive overrun, the job was aborted */
+	SSP_JOB_BUSY,		/**< Job queued or in progress */
+} SSP_JOB_STATUS_T;
+
+/** Keep the chip select asserted after the job, for a following job to the same device */
+#define SSP_JOB_CS_HOLD         (1 << 0)
+/** Job does not use a chip select */
+#define SSP_JOB_NO_CS           (1 << 1)
+
+/*
+ * @brief SSP queued job
+ */
+typedef struct SSP_JOB SSP_JOB_T;
+
+/*
+ * @brief SSP job callback, called from the SSP interrupt
+ */
+typedef void (*SSP_JOBCALLBACK_T)(LPC_SSP_T *, SSP_JOB_T *);
+
+/*
+ * @brief SSP queued job structure
+ */
+struct SSP_JOB {
+	SPI_Address_t cs;				/*!< GPIO chip select, active low, must be set up as output high */
+	SSP_ConfigFormat format;		/*!< Frame format of the job */
+	uint32_t bitRate;				/*!< Bit rate of the job, 0 for the rate set up when queued */
+	Chip_SSP_DATA_SETUP_T xf;		/*!< Transfer, counters are cleared when queued; length in bytes */
+	uint32_t flags;					/*!< OR'ed SSP_JOB_* flags */
+	SSP_JOBCALLBACK_T start;		/*!< Called before the chip select is asserted, may be NULL */
+	SSP_JOBCALLBACK_T callback;		/*!< Called once the job is done, may be NULL */
+	void *data;						/*!< Application data, not used by the driver */
+	volatile SSP_JOB_STATUS_T status;	/*!< Status of the job */
+	uint32_t cr0;					/*!< Used by the driver */
+	uint32_t cpsr;					/*!< Used by the driver */
+	SSP_JOB_T *next;				/*!< Used by the driver */
+};
+
 /**
  * @brief   Clean all data in RX FIFO of SSP
  * @param	pSSP			: The base SSP peripheral on the chip
@@ -533,6 +588,86 @@ uint32_t Chip_SSP_WriteFrames_Blocking(LPC_SSP_T *pSSP, uint8_t *buffer, uint32_
  */
 uint32_t Chip_SSP_ReadFrames_Blocking(LPC_SSP_T *pSSP, uint8_t *buffer, uint32_t buffer_len);
 
+/**
+ * @brief   Queue an interrupt driven SSP master transaction
+ * @param	pSSP			: The base SSP peripheral on the chip
+ * @param	job				: Pointer to the job, must stay valid until its callback is called
+ * @return	Nothing
+ * @note
+ * Returns immediately, jobs are run back to back from Chip_SSP_JobIRQHandler()
+ * using the RX FIFO half full and receive timeout interrupts. Each job
+ * sets its own frame format and bit rate, asserts its chip select, keeps
+ * up to #SSP_FIFO_DEPTH frames in flight and releases the chip select
+ * once all frames are received, unless #SSP_JOB_CS_HOLD is set. On
+ * completion @a job->status holds the result and the callback is called
+ * from the interrupt; it may queue further jobs. @a job->xf.length must
+ * not be 0. Do not mix with the other transfer functions while jobs are
+ * queued.
+ */
+void Chip_SSP_JobSubmit(LPC_SSP_T *pSSP, SSP_JOB_T *job);
+
+/**
+ * @brief   Check if SSP jobs are queued
+ * @param	pSSP			: The base SSP peripheral on the chip
+ * @return	1 if a job is queued or in progress, 0 otherwise
+ */
+int Chip_SSP_JobsPending(LPC_SSP_T *pSSP);
+
+/**
+ * @brief   SSP interrupt handler for queued jobs
+ * @param	pSSP			: The base SSP peripheral on the chip
+ * @return	Nothing
+ * @note	Must be called from the SSP interrupt handler when using Chip_SSP_JobSubmit()
+ */
+void Chip_SSP_JobIRQHandler(LPC_SSP_T *pSSP);
+
+/*
+ * @brief SSP DMA events passed to the SSP DMA callback
+ */
+typedef enum CHIP_SSP_DMA_EVENT {
+	SSP_DMA_EVENT_DONE,		/**< All frames have been sent and received */
+	SSP_DMA_EVENT_ERROR,	/**< DMA bus error, the transfer has been stopped */
+} SSP_DMA_EVENT_T;
+
+/*
+ * @brief SSP DMA callback, called from the DMA interrupt handler
+ */
+typedef void (*SSP_DMA_CALLBACK_T)(LPC_SSP_T *, SSP_DMA_EVENT_T);
+
+/**
+ * @brief   Full-duplex SSP transfer using DMA (non-blocking)
+ * @param	pSSP			: The base SSP peripheral on the chip
+ * @param	tx_data			: Frames to send, NULL to send 0xFF / 0xFFFF dummy frames
+ * @param	rx_data			: Memory for the received frames, NULL to drop them
+ * @param	numFrames		: Number of frames, uint8_t for frames up to 8 bits, uint16_t otherwise
+ * @param	callback		: Called once the transfer is done, may be NULL
+ * @return	ERROR if a DMA transfer is still in progress, SUCCESS otherwise
+ * @note
+ * The DMA controller must have been initialized with Chip_DMA_Init()
+ * and Chip_DMA_IRQHandler() must be called from DMA_IRQHandler(). The
+ * receive channel gets the higher priority so that the RX FIFO does not
+ * overrun. Transfers longer than DMA_MAX_XFER frames are split into
+ * several DMA cycles. The frame format must not change until the
+ * transfer is done.
+ */
+Status Chip_SSP_TransferDMA(LPC_SSP_T *pSSP, const void *tx_data, void *rx_data, uint32_t numFrames,
+							SSP_DMA_CALLBACK_T callback);
+
+/**
+ * @brief   Check if a DMA transfer is in progress
+ * @param	pSSP			: The base SSP peripheral on the chip
+ * @return	true if Chip_SSP_TransferDMA() frames are still being transferred
+ */
+bool Chip_SSP_IsDMABusy(LPC_SSP_T *pSSP);
+
+/**
+ * @brief   Stop a DMA transfer
+ * @param	pSSP			: The base SSP peripheral on the chip
+ * @return	Nothing
+ * @note	The callback is not called, frames left in the FIFOs are dropped
+ */
+void Chip_SSP_StopDMA(LPC_SSP_T *pSSP);
+
 /**
  * @brief   Initialize the SSP
  * @param	pSSP			: The base SSP peripheral on the chip
@@ -556,13 +691,38 @@ void Chip_SSP_DeInit(LPC_SSP_T *pSSP);
  */
 void Chip_SSP_SetMaster(LPC_SSP_T *pSSP, bool master);
 
+/*
+ * @brief SSP clock setup
+ */
+typedef struct {
+	uint8_t clkDiv;		/*!< SSP0CLKDIV value */
+	uint8_t cpsr;		/*!< CPSR value, even */
+	uint8_t scr;		/*!< SCR value */
+	uint32_t bitRate;	/*!< Achieved bit rate */
+} SSP_CLOCK_T;
+
+/**
+ * @brief   Find the SSP clock divider, prescale and SCR values for a bit rate
+ * @param	clkin			: Main clock rate
+ * @param	bitRate			: Target bit rate
+ * @param	pClk			: Pointer to the setup to fill
+ * @return	ERROR if @a bitRate is 0 or below the slowest rate, SUCCESS otherwise
+ * @note
+ * Picks the highest rate not above @a bitRate. Among the setups giving
+ * that rate the largest SSP0CLKDIV is chosen, for the lowest SSP clock.
+ * Runs at most 256 steps for all but very low rates. This function does
+ * not access the hardware.
+ */
+Status Chip_SSP_CalcBitRate(uint32_t clkin, uint32_t bitRate, SSP_CLOCK_T *pClk);
+
 /**
  * @brief   Set the clock frequency for SSP interface
  * @param	pSSP			: The base SSP peripheral on the chip
  * @param	bitRate		: The SSP bit rate
- * @return	Nothing
+ * @return	Achieved bit rate, 0 if @a bitRate can not be reached and nothing was changed
+ * @note	SSP0CLKDIV, CPSR and SCR are set up with Chip_SSP_CalcBitRate()
  */
-void Chip_SSP_SetBitRate(LPC_SSP_T *pSSP, uint32_t bitRate);
+uint32_t Chip_SSP_SetBitRate(LPC_SSP_T *pSSP, uint32_t bitRate);
 
 /**
  * @}
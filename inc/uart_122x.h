@@ -150,10 +150,11 @@ typedef struct {					/*!< USARTn Structure       */
 #define UART_FCR_FIFO_EN        (1 << 0)	/*!< UART FIFO enable */
 #define UART_FCR_RX_RS          (1 << 1)	/*!< UART RX FIFO reset */
 #define UART_FCR_TX_RS          (1 << 2)	/*!< UART TX FIFO reset */
-#define UART_FCR_DMAMODE_SEL    (1 << 3)	/*!< UART DMA mode selection - valid for 17xx/40xx, 18xx/43xx only */
+#define UART_FCR_DMAMODE_SEL    (1 << 3)	/*!< UART DMA mode selection */
 #define UART_FCR_BITMASK        (0xCF)		/*!< UART FIFO control bit mask */
 
 #define UART_TX_FIFO_SIZE       (16)
+#define UART_FCR_TRG_LEV_SHIFT  (6)			/*!< UART FIFO trigger level bit position */
 
 /* FIFO trigger level bit definitions */
 #define UART_FCR_TRG_LEV0       (0)			/*!< UART FIFO trigger level 0: 1 character */
@@ -403,12 +404,12 @@ STATIC INLINE uint32_t Chip_UART_ReadIntIDReg(LPC_USART_T *pUART)
  * @note	Use OR'ed value of UART_FCR_* definitions with this function
  *			to select specific options. For example, to enable the FIFOs
  *			with a RX trip level of 8 characters, use something like
- *			(UART_FCR_FIFO_EN | UART_FCR_TRG_LEV2)
+ *			(UART_FCR_FIFO_EN | UART_FCR_TRG_LEV2). The selected RX trigger
+ *			level is remembered by the driver (FCR is write-only) so the
+ *			ring buffer IRQ handler can drain that many bytes per receive
+ *			data available interrupt without polling the line status.
  */
-STATIC INLINE void Chip_UART_SetupFIFOS(LPC_USART_T *pUART, uint32_t fcr)
-{
-	pUART->FCR = fcr;
-}
+void Chip_UART_SetupFIFOS(LPC_USART_T *pUART, uint32_t fcr);
 
 /**
  * @brief	Configure data width, parity and stop bits
@@ -681,6 +682,49 @@ int Chip_UART_Send(LPC_USART_T *pUART, const void *data, int numBytes);
  */
 int Chip_UART_Read(LPC_USART_T *pUART, void *data, int numBytes);
 
+/**
+ * @brief UART baud rate divider setup
+ */
+typedef struct {
+	uint16_t dl;			/*!< Divisor latch value (DLM:DLL) */
+	uint8_t divAddVal;		/*!< Fractional divider DIVADDVAL, 0 when the fractional divider is not used */
+	uint8_t mulVal;			/*!< Fractional divider MULVAL */
+	uint32_t baudrate;		/*!< Achieved baud rate */
+	int32_t errorPpm;		/*!< Error of the achieved rate in ppm, positive when faster than requested */
+} UART_BAUD_T;
+
+/** Largest baud rate error accepted by the baud rate solver, in ppm */
+#define UART_BAUD_MAX_ERROR_PPM (30000)
+
+/**
+ * @brief	Get the UART peripheral clock rate
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @return	Main clock rate divided by UART0CLKDIV or UART1CLKDIV, 0 if the clock is disabled
+ */
+uint32_t Chip_UART_GetClockRate(LPC_USART_T *pUART);
+
+/**
+ * @brief	Find the dividers giving the closest rate to a target baud rate
+ * @param	clkin		: UART peripheral clock rate, see Chip_UART_GetClockRate()
+ * @param	baudrate	: Target baud rate (baud rate = bit rate)
+ * @param	useFDR		: true to search the fractional divider too, false for DL only
+ * @param	pBaud		: Pointer to the setup to fill
+ * @return	ERROR if no divider gets within UART_BAUD_MAX_ERROR_PPM, SUCCESS otherwise
+ * @note	Every valid DL, DIVADDVAL and MULVAL combination is considered.
+ *			On equal error, a setup without fractional divider and then the
+ *			lowest MULVAL is preferred. This function does not access the
+ *			hardware.
+ */
+Status Chip_UART_CalcBaud(uint32_t clkin, uint32_t baudrate, bool useFDR, UART_BAUD_T *pBaud);
+
+/**
+ * @brief	Program the baud rate dividers of a UART
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @param	pBaud	: Divider setup, from Chip_UART_CalcBaud()
+ * @return	Nothing
+ */
+void Chip_UART_SetBaudDividers(LPC_USART_T *pUART, const UART_BAUD_T *pBaud);
+
 /**
  * @brief	Sets best dividers to get a target bit rate (without fractional divider)
  * @param	pUART		: Pointer to selected UART peripheral
@@ -727,7 +771,8 @@ int Chip_UART_ReadBlocking(LPC_USART_T *pUART, void *data, int numBytes);
  * @return	Nothing
  * @note	If ring buffer support is desired for the receive side
  *			of data transfer, the UART interrupt should call this
- *			function for a receive based interrupt status.
+ *			function for a receive based interrupt status. The ring
+ *			buffer must be initialized with an item size of 1.
  */
 void Chip_UART_RXIntHandlerRB(LPC_USART_T *pUART, RINGBUFF_T *pRB);
 
@@ -738,7 +783,8 @@ void Chip_UART_RXIntHandlerRB(LPC_USART_T *pUART, RINGBUFF_T *pRB);
  * @return	Nothing
  * @note	If ring buffer support is desired for the transmit side
  *			of data transfer, the UART interrupt should call this
- *			function for a transmit based interrupt status.
+ *			function for a transmit based interrupt status. The ring
+ *			buffer must be initialized with an item size of 1.
  */
 void Chip_UART_TXIntHandlerRB(LPC_USART_T *pUART, RINGBUFF_T *pRB);
 
@@ -780,6 +826,284 @@ int Chip_UART_ReadRB(LPC_USART_T *pUART, RINGBUFF_T *pRB, void *data, int bytes)
  */
 void Chip_UART_IRQRBHandler(LPC_USART_T *pUART, RINGBUFF_T *pRXRB, RINGBUFF_T *pTXRB);
 
+/**
+ * @brief UART DMA events passed to the UART DMA callback
+ */
+typedef enum {
+	UART_DMA_EVENT_TX_DONE,		/*!< All data of Chip_UART_SendDMA() has been written to the transmit FIFO */
+	UART_DMA_EVENT_RX_BLOCK,	/*!< A receive buffer half has been filled */
+	UART_DMA_EVENT_RX_IDLE,		/*!< Receive line went idle (character time-out), partial data can be read */
+	UART_DMA_EVENT_ERROR		/*!< DMA bus error, the transfer has been stopped */
+} UART_DMA_EVENT_T;
+
+/**
+ * @brief UART DMA callback, called from the DMA and UART interrupt handlers
+ */
+typedef void (*UART_DMA_CALLBACK_T)(LPC_USART_T *pUART, UART_DMA_EVENT_T event);
+
+/**
+ * @brief	Register the DMA event callback of a UART
+ * @param	pUART		: Pointer to selected UART peripheral
+ * @param	callback	: Function to call on UART DMA events, or NULL for none
+ * @return	Nothing
+ */
+void Chip_UART_SetDMACallback(LPC_USART_T *pUART, UART_DMA_CALLBACK_T callback);
+
+/**
+ * @brief	Transmit a byte array through the UART using DMA (non-blocking)
+ * @param	pUART		: Pointer to selected UART peripheral
+ * @param	data		: Pointer to bytes to transmit, must stay valid until done
+ * @param	numBytes	: Number of bytes to transmit
+ * @return	ERROR if a DMA transmit is still in progress, SUCCESS otherwise
+ * @note	The DMA controller must have been initialized with Chip_DMA_Init()
+ *			and Chip_DMA_IRQHandler() must be called from DMA_IRQHandler().
+ *			Transfers longer than DMA_MAX_XFER are split into several DMA
+ *			cycles. UART_DMA_EVENT_TX_DONE is reported once the last byte
+ *			is in the transmit FIFO, it may still be shifting out.
+ */
+Status Chip_UART_SendDMA(LPC_USART_T *pUART, const void *data, int numBytes);
+
+/**
+ * @brief	Check if a DMA transmit is in progress
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @return	true if Chip_UART_SendDMA() data is still being transferred
+ */
+bool Chip_UART_IsSendDMABusy(LPC_USART_T *pUART);
+
+/**
+ * @brief	Start continuous DMA reception into a circular buffer
+ * @param	pUART		: Pointer to selected UART peripheral
+ * @param	buffer		: Pointer to the circular receive buffer
+ * @param	size		: Size of the buffer, a power of 2 from 2 to 2 * DMA_MAX_XFER
+ * @return	ERROR if size is invalid, SUCCESS otherwise
+ * @note	The buffer is filled in ping-pong mode, one half per DMA cycle,
+ *			and UART_DMA_EVENT_RX_BLOCK is reported for each filled half.
+ *			Received data can be read at any time with Chip_UART_ReadDMA().
+ *			The receive interrupt is enabled so that the application's UART
+ *			IRQ handler, which must call Chip_UART_DMAIRQHandler(), can
+ *			report UART_DMA_EVENT_RX_IDLE on a character time-out. The RX
+ *			trigger level is set to 14 characters while the DMA receives
+ *			and restored by Chip_UART_StopDMA().
+ */
+Status Chip_UART_ReceiveDMA(LPC_USART_T *pUART, void *buffer, int size);
+
+/**
+ * @brief	Get the number of bytes received by DMA and not yet read
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @return	Number of bytes that Chip_UART_ReadDMA() can return
+ */
+int Chip_UART_GetDMARxCount(LPC_USART_T *pUART);
+
+/**
+ * @brief	Copy data received by DMA out of the circular buffer
+ * @param	pUART		: Pointer to selected UART peripheral
+ * @param	data		: Pointer to buffer to fill
+ * @param	numBytes	: Size of the passed buffer
+ * @return	The number of bytes copied
+ * @note	If the application fell more than a buffer behind, the data
+ *			that was overwritten is dropped and Chip_UART_CheckDMARxOverrun()
+ *			returns true.
+ */
+int Chip_UART_ReadDMA(LPC_USART_T *pUART, void *data, int numBytes);
+
+/**
+ * @brief	Check and clear the DMA receive overrun flag
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @return	true if received data was dropped since the last call
+ */
+bool Chip_UART_CheckDMARxOverrun(LPC_USART_T *pUART);
+
+/**
+ * @brief	Stop DMA transmit and receive on a UART
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @return	Nothing
+ */
+void Chip_UART_StopDMA(LPC_USART_T *pUART);
+
+/**
+ * @brief	UART interrupt handler for DMA reception
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @return	Nothing
+ * @note	Reports UART_DMA_EVENT_RX_IDLE on a character time-out only.
+ *			The DMA keeps the receive FIFO below the trigger level, so a
+ *			time-out is the only receive interrupt in a stream. A time-out
+ *			that the DMA clears by draining the FIFO before this handler
+ *			reads the interrupt ID is not reported. The event only means
+ *			that everything received so far can be read.
+ */
+void Chip_UART_DMAIRQHandler(LPC_USART_T *pUART);
+
+/**
+ * @brief UART received frame record
+ */
+typedef struct {
+	uint8_t *data;			/*!< Pointer to the frame bytes */
+	uint16_t len;			/*!< Number of bytes in the frame */
+	uint16_t flags;			/*!< OR'ed UART_FRAME_* flags */
+} UART_FRAME_T;
+
+#define UART_FRAME_TRUNCATED    (1 << 0)	/*!< Frame was longer than a slot, the extra bytes were dropped */
+#define UART_FRAME_LINE_ERROR   (1 << 1)	/*!< Overrun, parity, framing error or break seen during the frame */
+
+/**
+ * @brief UART framed receive setup
+ */
+typedef struct {
+	RINGBUFF_T *pQueue;		/*!< Frame queue, initialized with an item size of sizeof(UART_FRAME_T) */
+	uint8_t *pool;			/*!< Frame storage, (pQueue->count + 2) slots of slotSize bytes */
+	uint16_t slotSize;		/*!< Size of a slot, the longest frame that can be received */
+	LPC_TIMER_T *pTimer;	/*!< LPC_TIMER16_0 or LPC_TIMER16_1, used only for the gap */
+	uint32_t gapUs;			/*!< Receive silence that ends a frame, in microseconds */
+} UART_FRAME_SETUP_T;
+
+/**
+ * @brief	Start framed receive mode on a UART
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @param	pSetup	: Pointer to framed receive setup, copied by the driver
+ * @return	ERROR if the setup is invalid, SUCCESS otherwise
+ * @note	Received bytes are collected into a pool slot until the line
+ *			has been silent for gapUs, then the frame is added to the
+ *			frame queue as a UART_FRAME_T record. A frame keeps its slot
+ *			until the application has popped it and all frames queued
+ *			after it, so it can be processed in place. The timer is
+ *			restarted on every receive interrupt: with a trigger level of
+ *			1 character the gap is measured from the last byte, with higher
+ *			levels the tail of a frame is picked up by the character
+ *			time-out, which already implies about 4 silent character times.
+ *			The application UART and timer IRQ handlers must call
+ *			Chip_UART_FrameIRQHandler() and Chip_UART_FrameTimerIRQHandler()
+ *			and must not preempt each other.
+ */
+Status Chip_UART_FrameInit(LPC_USART_T *pUART, const UART_FRAME_SETUP_T *pSetup);
+
+/**
+ * @brief	Stop framed receive mode on a UART
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @return	Nothing
+ */
+void Chip_UART_FrameDeInit(LPC_USART_T *pUART);
+
+/**
+ * @brief	Get the next received frame
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @param	pFrame	: Pointer to the record to fill
+ * @return	1 if a frame was returned, 0 if the frame queue is empty
+ */
+int Chip_UART_FrameRead(LPC_USART_T *pUART, UART_FRAME_T *pFrame);
+
+/**
+ * @brief	Get the number of frames dropped because the frame queue was full
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @return	Number of dropped frames since Chip_UART_FrameInit()
+ */
+uint32_t Chip_UART_FrameGetDropped(LPC_USART_T *pUART);
+
+/**
+ * @brief	UART interrupt handler for framed receive mode
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @return	Nothing
+ * @note	Handles both receive data available and character time-out
+ *			interrupts by moving the FIFO into the current frame and
+ *			restarting the gap timer.
+ */
+void Chip_UART_FrameIRQHandler(LPC_USART_T *pUART);
+
+/**
+ * @brief	Gap timer interrupt handler for framed receive mode
+ * @param	pUART	: Pointer to the UART using the timer
+ * @return	Nothing
+ * @note	Ends the current frame, unless bytes are still waiting in the
+ *			receive FIFO, in which case they are added and the gap timer
+ *			is restarted.
+ */
+void Chip_UART_FrameTimerIRQHandler(LPC_USART_T *pUART);
+
+/**
+ * @brief UART RS-485 setup
+ */
+typedef struct {
+	uint32_t options;		/*!< OR'ed UART_RS485_* options */
+	uint8_t address;		/*!< Station address, used in multidrop mode */
+	uint8_t dirDelay;		/*!< Direction pin hold time after the last stop bit, in bit times */
+} UART_RS485_SETUP_T;
+
+#define UART_RS485_DIR_DTR          UART_RS485CTRL_SEL_DTR	/*!< Drive the direction pin on DTR instead of RTS */
+#define UART_RS485_DIR_ACTIVE_HIGH  UART_RS485CTRL_OINV_1	/*!< Direction pin is high while transmitting */
+#define UART_RS485_MULTIDROP        (1 << 8)	/*!< 9-bit multidrop mode, the 9th bit marks address bytes */
+#define UART_RS485_AUTO_ADDRESS     (1 << 9)	/*!< Hardware address match enables the receiver, implies multidrop */
+
+/**
+ * @brief	Set up a UART for RS-485 with hardware direction control
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @param	pSetup	: Pointer to RS-485 setup
+ * @return	Nothing
+ * @note	The RTS (or DTR) pin must be routed to the UART with IOCON. It
+ *			is asserted by the UART while data is sent and released
+ *			dirDelay bit times after the last stop bit, so the ring buffer
+ *			and DMA transmit functions need no direction handling. In
+ *			multidrop mode the parity bit is used as the 9th (address) bit
+ *			and is forced to 0 for data bytes. With UART_RS485_AUTO_ADDRESS
+ *			the receiver stays disabled until an address byte matching
+ *			pSetup->address is received, so only traffic for this station
+ *			reaches the ring buffer or DMA receive buffer. Without it, the
+ *			address match is done by Chip_UART_RS485IRQRBHandler().
+ */
+void Chip_UART_RS485Init(LPC_USART_T *pUART, const UART_RS485_SETUP_T *pSetup);
+
+/**
+ * @brief	Disable RS-485 mode on a UART
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @return	Nothing
+ * @note	Parity is left disabled.
+ */
+void Chip_UART_RS485DeInit(LPC_USART_T *pUART);
+
+/**
+ * @brief	Send a multidrop address byte (blocking)
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @param	addr	: Address of the station to select
+ * @return	Nothing
+ * @note	Waits for the transmitter to go idle, sends the address with
+ *			the 9th bit set and waits for it to be sent so that the data
+ *			that follows, sent by any transmit function, has the 9th bit
+ *			cleared.
+ */
+void Chip_UART_RS485SendAddress(LPC_USART_T *pUART, uint8_t addr);
+
+/**
+ * @brief	Check if the RS-485 transmitter is idle
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @return	true if the transmit FIFO and shift register are empty
+ * @note	The direction pin is released dirDelay bit times later.
+ */
+STATIC INLINE bool Chip_UART_RS485IsTxIdle(LPC_USART_T *pUART)
+{
+	return (bool) ((pUART->LSR & UART_LSR_TEMT) != 0);
+}
+
+/**
+ * @brief	Ignore received data until this station is addressed again
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @return	Nothing
+ * @note	In auto address mode this disables the receiver until the
+ *			hardware detects a matching address byte.
+ */
+void Chip_UART_RS485WaitAddress(LPC_USART_T *pUART);
+
+/**
+ * @brief	UART RS-485 interrupt handler for ring buffers
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @param	pRXRB	: Pointer to receive ring buffer
+ * @param	pTXRB	: Pointer to transmit ring buffer
+ * @return	Nothing
+ * @note	Same as Chip_UART_IRQRBHandler(), but address bytes are not
+ *			stored. In multidrop mode without auto address detection,
+ *			data bytes are only stored after an address byte matching the
+ *			station address. Enable UART_IER_RLSINT along with
+ *			UART_IER_RBRINT, address bytes are flagged as parity errors.
+ */
+void Chip_UART_RS485IRQRBHandler(LPC_USART_T *pUART, RINGBUFF_T *pRXRB, RINGBUFF_T *pTXRB);
+
 /**
  * @}
  */
@@ -29,12 +29,20 @@
  * this code.
  */
 
+#include <string.h>
 #include "chip.h"
 
 #if !defined(CHIP_LPC1125)
 
 /*****************************************************************************
  * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Active burst scan */
+static ADC_SCAN_T *adcScan;
+
+/* Active watchdog */
+static ADC_WATCHDOG_T *adcWatchdog;
 
 /*****************************************************************************
  * Public types/enumerations/variables
@@ -50,12 +58,12 @@ STATIC INLINE uint8_t getFullConvClk(void)
 	return 11;
 }
 
-/* Get divider value */
-STATIC uint8_t getClkDiv(LPC_ADC_T *pADC, bool burstMode, uint32_t adcRate, uint8_t clks)
+/* Get divider value, may not fit the 8-bit CLKDIV field */
+STATIC uint32_t getClkDiv(LPC_ADC_T *pADC, bool burstMode, uint32_t adcRate, uint8_t clks)
 {
 	uint32_t adcBlockFreq;
 	uint32_t fullAdcRate;
-	uint8_t div;
+	uint32_t div;
 
 	/* The APB clock (PCLK_ADC0) is divided by (CLKDIV+1) to produce the clock for
 	   A/D converter, which should be less than or equal to 4.5MHz.
@@ -99,6 +107,78 @@ Status readAdcVal(LPC_ADC_T *pADC, uint8_t channel, uint16_t *data)
 	return SUCCESS;
 }
 
+/* Check a scan setup, select its channels and make it the active scan.
+   Returns the highest channel of the list, -1 if the setup is not valid */
+STATIC int setupScan(LPC_ADC_T *pADC, ADC_SCAN_T *scan)
+{
+	int ch, last = -1;
+
+	if ((scan->channels == 0) || (scan->buffer == NULL) || (scan->scanRate == 0) ||
+		(scan->numScans < 2) || (scan->numScans & 1)) {
+		return -1;
+	}
+
+	scan->numChannels = 0;
+	for (ch = 0; ch < 8; ch++) {
+		if (scan->channels & ADC_CR_CH_SEL(ch)) {
+			scan->numChannels++;
+			last = ch;
+		}
+	}
+	if (scan->oversample && (scan->oversample->numChannels != scan->numChannels)) {
+		return -1;
+	}
+
+	pADC->CR = (pADC->CR & ~0xFFUL) | scan->channels;
+
+	/* Reading the results clears the DONE and OVERRUN flags, so that the
+	   first scan is not flagged */
+	for (ch = 0; ch <= last; ch++) {
+		if (scan->channels & ADC_CR_CH_SEL(ch)) {
+			(void) pADC->DR[ch];
+		}
+	}
+	scan->index = 0;
+	adcScan = scan;
+
+	return last;
+}
+
+/* Post a watchdog event */
+STATIC void postWatchdogEvent(ADC_WATCHDOG_T *wd, uint8_t channel, ADC_WD_EVENT_T event, uint16_t value)
+{
+	ADC_WD_ENTRY_T entry;
+
+	entry.timestamp = wd->pTimer ? wd->pTimer->TC : 0;
+	entry.value = value;
+	entry.channel = channel;
+	entry.event = (uint8_t) event;
+	if (!RingBuffer_Insert(wd->events, &entry)) {
+		wd->lost++;
+	}
+}
+
+/* Check a result against the window of its channel */
+STATIC void checkWatchdog(ADC_WATCHDOG_T *wd, uint8_t channel, uint16_t value)
+{
+	ADC_WD_EVENT_T event;
+
+	if (value < wd->low[channel]) {
+		event = ADC_WD_BELOW;
+	}
+	else if (value > wd->high[channel]) {
+		event = ADC_WD_ABOVE;
+	}
+	else {
+		event = ADC_WD_INSIDE;
+	}
+
+	if (event != wd->state[channel]) {
+		wd->state[channel] = (uint8_t) event;
+		postWatchdogEvent(wd, channel, event, value);
+	}
+}
+
 /*****************************************************************************
  * Public functions
  ****************************************************************************/
@@ -123,7 +203,7 @@ void Chip_ADC_Init(LPC_ADC_T *pADC, ADC_CLOCK_SETUP_T *ADCSetup)
 	clk = 11;
 
 	ADCSetup->burstMode = false;
-	div = getClkDiv(pADC, false, ADCSetup->adcRate, clk);
+	div = (uint8_t) getClkDiv(pADC, false, ADCSetup->adcRate, clk);
 	cr |= ADC_CR_CLKDIV(div);
 	cr |= ADC_CR_BITACC(ADCSetup->bitsAccuracy);
 	pADC->CR = cr;
@@ -197,7 +277,7 @@ void Chip_ADC_SetSampleRate(LPC_ADC_T *pADC, ADC_CLOCK_SETUP_T *ADCSetup, uint32
 
 	cr = pADC->CR & (~ADC_SAMPLE_RATE_CONFIG_MASK);
 	ADCSetup->adcRate = rate;
-	div = getClkDiv(pADC, ADCSetup->burstMode, rate, (11 - ADCSetup->bitsAccuracy));
+	div = (uint8_t) getClkDiv(pADC, ADCSetup->burstMode, rate, (11 - ADCSetup->bitsAccuracy));
 	cr |= ADC_CR_CLKDIV(div);
 	cr |= ADC_CR_BITACC(ADCSetup->bitsAccuracy);
 	pADC->CR = cr;
@@ -247,4 +327,318 @@ Status Chip_ADC_ReadByte(LPC_ADC_T *pADC, ADC_CHANNEL_T channel, uint8_t *data)
 	return rt;
 }
 
+/* Start continuous burst conversion of a channel list */
+Status Chip_ADC_ScanStart(LPC_ADC_T *pADC, ADC_CLOCK_SETUP_T *ADCSetup, ADC_SCAN_T *scan)
+{
+	uint32_t clk, rate, div;
+	uint8_t clks;
+	int last;
+
+	Chip_ADC_ScanStop(pADC, ADCSetup);
+	last = setupScan(pADC, scan);
+	if ((last < 0) || (scan->scanRate > ADC_MAX_SAMPLE_RATE)) {
+		adcScan = NULL;
+		return ERROR;
+	}
+
+	/* The divider must fit CLKDIV and keep the ADC clock within its limit */
+	clk = Chip_Clock_GetSystemClockRate();
+	clks = 11 - ADCSetup->bitsAccuracy;
+	rate = scan->scanRate * scan->numChannels;
+	div = getClkDiv(pADC, true, rate, clks);
+	if ((div > 0xFF) || ((clk / (div + 1)) > (ADC_MAX_SAMPLE_RATE * getFullConvClk()))) {
+		adcScan = NULL;
+		return ERROR;
+	}
+
+	ADCSetup->burstMode = true;
+	Chip_ADC_SetSampleRate(pADC, ADCSetup, rate);
+	scan->scanRate = clk / ((div + 1) * clks * scan->numChannels);
+
+	/* The burst converts the channels in ascending order, the last one
+	   completes a scan */
+	pADC->INTEN = ADC_CR_CH_SEL(last);
+	Chip_ADC_SetBurstCmd(pADC, ENABLE);
+
+	return SUCCESS;
+}
+
+/* Start sampling one channel at a fixed rate set by a timer match */
+uint32_t Chip_ADC_SampleStart(LPC_ADC_T *pADC, ADC_CLOCK_SETUP_T *ADCSetup, ADC_SCAN_T *scan,
+							  LPC_TIMER_T *pTimer, int8_t matchnum)
+{
+	ADC_START_MODE_T mode;
+	uint32_t clk, half, prescale = 1;
+	int ch;
+
+	if (pTimer == LPC_TIMER32_0) {
+		mode = ADC_START_ON_CT32B0_MAT0;
+	}
+	else if (pTimer == LPC_TIMER16_0) {
+		mode = ADC_START_ON_CT16B0_MAT0;
+	}
+	else {
+		return 0;
+	}
+	if ((matchnum < 0) || (matchnum > 1) || (scan->scanRate > ADCSetup->adcRate)) {
+		return 0;
+	}
+
+	Chip_ADC_ScanStop(pADC, ADCSetup);
+	ch = setupScan(pADC, scan);
+	if ((ch < 0) || (scan->numChannels != 1)) {
+		adcScan = NULL;
+		return 0;
+	}
+
+	/* The match output toggles every half period, the ADC starts on its
+	   rising edge */
+	clk = Chip_Clock_GetSystemClockRate();
+	half = MAX((clk + scan->scanRate) / (2 * scan->scanRate), 1);
+	if ((pTimer == LPC_TIMER16_0) && (half > 0x10000)) {
+		prescale = (half + 0xFFFF) / 0x10000;
+		half = (half + (prescale / 2)) / prescale;
+	}
+
+	Chip_TIMER_Init(pTimer);
+	pTimer->TCR = 0;
+	pTimer->CTCR = 0;
+	pTimer->PC = 0;
+	pTimer->TC = 0;
+	Chip_TIMER_PrescaleSet(pTimer, prescale - 1);
+	Chip_TIMER_SetMatch(pTimer, matchnum, half - 1);
+	pTimer->MCR = TIMER_RESET_ON_MATCH(matchnum);
+	Chip_TIMER_ExtMatchControlSet(pTimer, 0, TIMER_EXTMATCH_TOGGLE, matchnum);
+
+	Chip_ADC_SetStartMode(pADC, (ADC_START_MODE_T) (mode + matchnum), ADC_TRIGGERMODE_RISING);
+	pADC->INTEN = ADC_CR_CH_SEL(ch);
+	Chip_TIMER_Enable(pTimer);
+
+	scan->scanRate = clk / (2 * prescale * half);
+	return scan->scanRate;
+}
+
+/* Stop timer triggered sampling */
+void Chip_ADC_SampleStop(LPC_ADC_T *pADC, ADC_CLOCK_SETUP_T *ADCSetup, LPC_TIMER_T *pTimer)
+{
+	Chip_TIMER_Disable(pTimer);
+	Chip_ADC_ScanStop(pADC, ADCSetup);
+}
+
+/* Stop the burst scan */
+void Chip_ADC_ScanStop(LPC_ADC_T *pADC, ADC_CLOCK_SETUP_T *ADCSetup)
+{
+	Chip_ADC_SetBurstCmd(pADC, DISABLE);
+	ADCSetup->burstMode = false;
+	adcScan = NULL;
+
+	/* Hand the results back to the watchdog interrupt */
+	pADC->INTEN = adcWatchdog ? adcWatchdog->channels : 0;
+}
+
+/* Set up an oversampling stage */
+Status Chip_ADC_OversampleInit(ADC_OVERSAMPLE_T *os, ADC_OSCHAN_T *chan, uint8_t numChannels,
+							   uint8_t osShift, uint8_t cicOrder, uint8_t iirShift)
+{
+	if ((numChannels == 0) || (numChannels > 8) || (osShift > 6) || (cicOrder == 0) ||
+		(cicOrder > ADC_CIC_MAX_ORDER) || (iirShift > 15) || ((10 + (2 * osShift * cicOrder)) > 32)) {
+		return ERROR;
+	}
+
+	memset(chan, 0, numChannels * sizeof(*chan));
+	os->chan = chan;
+	os->numChannels = numChannels;
+	os->osShift = osShift;
+	os->cicOrder = cicOrder;
+	os->iirShift = iirShift;
+	/* The CIC gain is (4^osShift)^cicOrder, keep osShift extra bits */
+	os->outShift = osShift * ((2 * cicOrder) - 1);
+	os->count = 0;
+	os->warmup = cicOrder;
+
+	return SUCCESS;
+}
+
+/* Feed one scan to an oversampling stage */
+void Chip_ADC_OversampleInput(ADC_OVERSAMPLE_T *os, const uint16_t *samples)
+{
+	ADC_OSCHAN_T *c = os->chan;
+	uint32_t i, n, v, t;
+	bool output, prime = false;
+
+	output = (++os->count == (1UL << (2 * os->osShift)));
+	if (output) {
+		os->count = 0;
+		/* The first cicOrder - 1 outputs are the CIC start-up transient,
+		   the next one preloads the IIR state */
+		if (os->warmup) {
+			prime = (--os->warmup == 0);
+		}
+	}
+
+	for (i = 0; i < os->numChannels; i++, c++) {
+		v = samples[i] & ~ADC_SCAN_OVERRUN;
+		for (n = 0; n < os->cicOrder; n++) {
+			c->integ[n] += v;
+			v = c->integ[n];
+		}
+		if (!output) {
+			continue;
+		}
+
+		for (n = 0; n < os->cicOrder; n++) {
+			t = v - c->comb[n];
+			c->comb[n] = v;
+			v = t;
+		}
+		if (os->warmup) {
+			continue;
+		}
+		v >>= os->outShift;
+
+		/* y += (x - y) / 2^iirShift, with the state holding y * 2^iirShift */
+		if (os->iirShift) {
+			if (prime) {
+				c->iir = v << os->iirShift;
+			}
+			else {
+				c->iir += v - (c->iir >> os->iirShift);
+			}
+			v = c->iir >> os->iirShift;
+		}
+		c->value = (uint16_t) v;
+	}
+
+	if (output && !os->warmup && os->callback) {
+		os->callback(os);
+	}
+}
+
+/* ADC interrupt handler for the burst scan */
+void Chip_ADC_ScanIRQHandler(LPC_ADC_T *pADC)
+{
+	ADC_SCAN_T *scan = adcScan;
+	ADC_WATCHDOG_T *wd = adcWatchdog;
+	uint32_t ch, mask, dr, index, half;
+	uint16_t *dst, *samples;
+
+	if (scan == NULL) {
+		return;
+	}
+
+	index = scan->index;
+	dst = samples = &scan->buffer[index * scan->numChannels];
+	for (ch = 0, mask = scan->channels; mask != 0; ch++, mask >>= 1) {
+		if (mask & 1) {
+			dr = pADC->DR[ch];
+			*dst++ = (uint16_t) (ADC_DR_RESULT(dr) |
+								 ((!ADC_DR_DONE(dr) || ADC_DR_OVERRUN(dr)) ? ADC_SCAN_OVERRUN : 0));
+			if (wd && (wd->channels & ADC_CR_CH_SEL(ch))) {
+				checkWatchdog(wd, ch, ADC_DR_RESULT(dr));
+			}
+		}
+	}
+
+	if (scan->oversample) {
+		Chip_ADC_OversampleInput(scan->oversample, samples);
+	}
+
+	index++;
+	half = scan->numScans / 2;
+	if (index == scan->numScans) {
+		index = 0;
+	}
+	scan->index = index;
+
+	if (scan->callback) {
+		if (index == half) {
+			scan->callback(scan, ADC_SCAN_HALF, scan->buffer);
+		}
+		else if (index == 0) {
+			scan->callback(scan, ADC_SCAN_FULL, &scan->buffer[half * scan->numChannels]);
+		}
+	}
+}
+
+/* Set up an ADC watchdog */
+Status Chip_ADC_WatchdogInit(ADC_WATCHDOG_T *wd, RINGBUFF_T *events, LPC_TIMER_T *pTimer)
+{
+	if (events->itemSz != sizeof(ADC_WD_ENTRY_T)) {
+		return ERROR;
+	}
+
+	memset(wd, 0, sizeof(*wd));
+	wd->events = events;
+	wd->pTimer = pTimer;
+
+	return SUCCESS;
+}
+
+/* Set the window of a channel */
+void Chip_ADC_WatchdogSetWindow(ADC_WATCHDOG_T *wd, ADC_CHANNEL_T channel, uint16_t low, uint16_t high)
+{
+	wd->low[channel] = low;
+	wd->high[channel] = high;
+	wd->state[channel] = ADC_WD_INSIDE;
+	wd->channels |= ADC_CR_CH_SEL(channel);
+}
+
+/* Remove the window of a channel */
+void Chip_ADC_WatchdogClearWindow(ADC_WATCHDOG_T *wd, ADC_CHANNEL_T channel)
+{
+	wd->channels &= ~ADC_CR_CH_SEL(channel);
+}
+
+/* Start checking conversion results against the windows */
+void Chip_ADC_WatchdogStart(LPC_ADC_T *pADC, ADC_WATCHDOG_T *wd)
+{
+	uint8_t ch;
+
+	Chip_ADC_WatchdogStop(pADC);
+	adcWatchdog = wd;
+
+	/* A running scan already reads the results from its interrupt */
+	if (adcScan == NULL) {
+		Chip_ADC_Int_SetGlobalCmd(pADC, DISABLE);
+		for (ch = 0; ch < 8; ch++) {
+			if (wd->channels & ADC_CR_CH_SEL(ch)) {
+				Chip_ADC_Int_SetChannelCmd(pADC, ch, ENABLE);
+			}
+		}
+	}
+}
+
+/* Stop the ADC watchdog */
+void Chip_ADC_WatchdogStop(LPC_ADC_T *pADC)
+{
+	if (adcWatchdog && (adcScan == NULL)) {
+		pADC->INTEN &= ~adcWatchdog->channels;
+	}
+	adcWatchdog = NULL;
+}
+
+/* ADC interrupt handler for the watchdog without a scan */
+void Chip_ADC_WatchdogIRQHandler(LPC_ADC_T *pADC)
+{
+	ADC_WATCHDOG_T *wd = adcWatchdog;
+	uint32_t ch, done;
+
+	if ((wd == NULL) || (adcScan != NULL)) {
+		return;
+	}
+
+	done = pADC->STAT & wd->channels;
+	for (ch = 0; done != 0; ch++, done >>= 1) {
+		if (done & 1) {
+			checkWatchdog(wd, ch, ADC_DR_RESULT(pADC->DR[ch]));
+		}
+	}
+}
+
+/* Post a first-level trip event */
+void Chip_ADC_WatchdogTrip(ADC_WATCHDOG_T *wd, uint8_t source)
+{
+	postWatchdogEvent(wd, source, ADC_WD_TRIP, 0);
+}
+
 #endif /* !defined(CHIP_LPC1125) */
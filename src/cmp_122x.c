@@ -0,0 +1,157 @@
+/*
+ * @brief LPC122x analog comparator chip driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2012
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#include "chip.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Update control register bits without clearing pending edge flags */
+STATIC void cmpModify(LPC_CMP_T *pCMP, uint32_t clr, uint32_t set)
+{
+	pCMP->CMP = (pCMP->CMP & ~(clr | CMP_INT_MASK)) | set;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Initialize the comparators */
+void Chip_CMP_Init(LPC_CMP_T *pCMP)
+{
+	Chip_SYSCTL_PowerUp(SYSCTL_POWERDOWN_COMP_PD);
+	Chip_Clock_EnablePeriphClock(SYSCTL_CLOCK_CMP);
+	Chip_SYSCTL_PeriphReset(RESET_ACMP);
+
+	pCMP->VLAD = 0;
+	pCMP->CMP = CMP_INT_MASK;
+}
+
+/* Shutdown the comparators */
+void Chip_CMP_DeInit(LPC_CMP_T *pCMP)
+{
+	pCMP->CMP = CMP_INT_MASK;
+	pCMP->VLAD = 0;
+	Chip_Clock_DisablePeriphClock(SYSCTL_CLOCK_CMP);
+	Chip_SYSCTL_PowerDown(SYSCTL_POWERDOWN_COMP_PD);
+}
+
+/* Select the inputs of a comparator */
+void Chip_CMP_SetInputs(LPC_CMP_T *pCMP, CMP_ID_T id, CMP_INPUT_T vp, CMP_INPUT_T vm)
+{
+	cmpModify(pCMP, CMP_INPUT_MASK(id), CMP_VP_CTRL(id, vp) | CMP_VM_CTRL(id, vm));
+}
+
+/* Set up and enable the voltage ladder */
+void Chip_CMP_SetupLadder(LPC_CMP_T *pCMP, uint8_t step, bool vddcmp)
+{
+	pCMP->VLAD = CMP_VLAD_EN | CMP_VLAD_VSEL(step) | (vddcmp ? CMP_VLAD_REF_VDDCMP : 0);
+}
+
+/* Enable or disable the hysteresis of a comparator */
+void Chip_CMP_SetHysteresis(LPC_CMP_T *pCMP, CMP_ID_T id, bool enable)
+{
+	cmpModify(pCMP, CMP_HYS(id), enable ? CMP_HYS(id) : 0);
+}
+
+/* Enable or disable the synchronization of a comparator output */
+void Chip_CMP_SetSync(LPC_CMP_T *pCMP, CMP_ID_T id, bool enable)
+{
+	cmpModify(pCMP, CMP_SYNC(id), enable ? CMP_SYNC(id) : 0);
+}
+
+/* Select the output edges setting the edge detected flag */
+void Chip_CMP_SetIntEdge(LPC_CMP_T *pCMP, CMP_ID_T id, CMP_EDGE_T edge)
+{
+	uint32_t set = 0;
+
+	if (edge == CMP_EDGE_BOTH) {
+		set = CMP_INTBOTH(id);
+	}
+	else if (edge == CMP_EDGE_RISING) {
+		set = CMP_INTPOL(id);
+	}
+	cmpModify(pCMP, CMP_INTBOTH(id) | CMP_INTPOL(id), set);
+
+	/* An edge may have been flagged while switching */
+	Chip_CMP_ClearIntStatus(pCMP, id);
+}
+
+/* Capture the timer count on comparator output edges */
+void Chip_CMP_SetupCapture(LPC_CMP_T *pCMP, CMP_ID_T id, LPC_TIMER_T *pTimer, int8_t capnum,
+						   CMP_EDGE_T edge, uint32_t prescale)
+{
+	uint32_t ccr = TIMER_INT_ON_CAP(capnum);
+
+	if (edge != CMP_EDGE_FALLING) {
+		ccr |= TIMER_CAP_RISING(capnum);
+	}
+	if (edge != CMP_EDGE_RISING) {
+		ccr |= TIMER_CAP_FALLING(capnum);
+	}
+
+	/* The capture input samples the output on the bus clock */
+	Chip_CMP_SetSync(pCMP, id, true);
+
+	Chip_TIMER_Init(pTimer);
+	pTimer->TCR = 0;
+	pTimer->CTCR = 0;
+	pTimer->PC = 0;
+	pTimer->TC = 0;
+	Chip_TIMER_PrescaleSet(pTimer, prescale ? (prescale - 1) : 0);
+	pTimer->CCR = (pTimer->CCR & ~(7UL << (capnum * 3))) | ccr;
+	Chip_TIMER_ClearCapture(pTimer, capnum);
+	Chip_TIMER_Enable(pTimer);
+}
+
+/* Get the time between the last two captures */
+uint32_t Chip_CMP_CapturePeriod(LPC_TIMER_T *pTimer, int8_t capnum, uint32_t *last)
+{
+	uint32_t now = Chip_TIMER_ReadCapture(pTimer, capnum);
+	uint32_t period = now - *last;
+
+	*last = now;
+	if ((pTimer == LPC_TIMER16_0) || (pTimer == LPC_TIMER16_1)) {
+		period &= 0xFFFF;
+	}
+
+	return period;
+}
@@ -0,0 +1,321 @@
+/*
+ * @brief LPC122x CRC engine chip driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2012
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#if defined(CORE_M0)
+#include "chip.h"
+#else
+#include "crc_122x.h"
+#endif
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Shift register update for the top 4 bits, one table per polynomial */
+static const uint32_t crcTable[CRC_POLY_LAST][16] = {
+	{0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	 0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF},
+	{0x0000, 0x8005, 0x800F, 0x000A, 0x801B, 0x001E, 0x0014, 0x8011,
+	 0x8033, 0x0036, 0x003C, 0x8039, 0x0028, 0x802D, 0x8027, 0x0022},
+	{0x00000000, 0x04C11DB7, 0x09823B6E, 0x0D4326D9, 0x130476DC, 0x17C56B6B, 0x1A864DB2, 0x1E475005,
+	 0x2608EDB8, 0x22C9F00F, 0x2F8AD6D6, 0x2B4BCB61, 0x350C9B64, 0x31CD86D3, 0x3C8EA00A, 0x384FBDBD},
+};
+
+/* Shift register width of each polynomial */
+static const uint8_t crcWidth[CRC_POLY_LAST] = {16, 16, 32};
+
+/* Bit reversed nibbles */
+static const uint8_t crcRev4[16] = {
+	0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF
+};
+
+#if defined(CORE_M0)
+/* DMA feed state */
+typedef struct {
+	CRC_DMA_CALLBACK_T callback;	/* Completion callback */
+	const uint8_t *next;			/* Next bytes to feed */
+	uint32_t left;					/* Bytes not yet handed to the DMA */
+	volatile bool busy;				/* Chip_CRC_UpdateDMA() in progress */
+} CRC_DMA_STATE_T;
+
+static CRC_DMA_STATE_T crcDMA;
+#endif
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Default MODE options and seed of a polynomial */
+STATIC void getDefaultConfig(CRC_POLY_T poly, uint32_t *flags, uint32_t *seed)
+{
+	switch (poly) {
+	case CRC_POLY_CRC16:
+		*flags = MODE_CFG_CRC16;
+		*seed = CRC_SEED_CRC16;
+		break;
+
+	case CRC_POLY_CRC32:
+		*flags = MODE_CFG_CRC32;
+		*seed = CRC_SEED_CRC32;
+		break;
+
+	default:
+		*flags = MODE_CFG_CCITT;
+		*seed = CRC_SEED_CCITT;
+		break;
+	}
+}
+
+/* Mask of the shift register bits of a polynomial */
+STATIC uint32_t getMask(uint32_t poly)
+{
+	return (crcWidth[poly] == 32) ? 0xFFFFFFFF : ((1UL << crcWidth[poly]) - 1);
+}
+
+/* Reverse the bit order of a byte */
+STATIC uint32_t reverse8(uint32_t b)
+{
+	return (crcRev4[b & 0xF] << 4) | crcRev4[(b >> 4) & 0xF];
+}
+
+#if defined(CORE_M0)
+/* Hand the next bytes to the DMA */
+STATIC void CRC_DMASendChunk(void)
+{
+	uint32_t cnt = MIN(crcDMA.left, DMA_MAX_XFER);
+
+	Chip_DMA_Transfer(LPC_DMA, CRC_DMA_CHANNEL, DMA_CTRL_CYCLE_AUTO | DMA_XFER_MEM2PER_8 | DMA_CTRL_R_POWER(4),
+					  crcDMA.next, &LPC_CRC->WRDATA8, cnt);
+	crcDMA.next += cnt;
+	crcDMA.left -= cnt;
+	Chip_DMA_SWTrigger(LPC_DMA, CRC_DMA_CHANNEL);
+}
+
+/* End a DMA feed */
+STATIC void CRC_DMAFinish(Status status)
+{
+	crcDMA.left = 0;
+	crcDMA.busy = false;
+	if (crcDMA.callback) {
+		crcDMA.callback(status);
+	}
+}
+
+/* DMA channel callback */
+STATIC void CRC_DMACallback(DMA_CHID_T ch, DMA_EVENT_T event)
+{
+	(void) ch;
+	if (event == DMA_EVENT_ERROR) {
+		CRC_DMAFinish(ERROR);
+	}
+	else if (crcDMA.left) {
+		CRC_DMASendChunk();
+	}
+	else {
+		CRC_DMAFinish(SUCCESS);
+	}
+}
+#endif
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Start a software CRC */
+void Chip_CRC_SWInit(CRC_SW_T *crc, CRC_POLY_T poly, uint32_t flags, uint32_t seed)
+{
+	crc->mode = (uint32_t) poly | flags;
+	crc->sum = seed & getMask(poly);
+}
+
+/* Start a software CRC with the default setup of a polynomial */
+void Chip_CRC_SWDefault(CRC_SW_T *crc, CRC_POLY_T poly)
+{
+	uint32_t flags, seed;
+
+	getDefaultConfig(poly, &flags, &seed);
+	Chip_CRC_SWInit(crc, poly, flags, seed);
+}
+
+/* Feed bytes to a software CRC */
+void Chip_CRC_SWUpdate(CRC_SW_T *crc, const void *data, uint32_t bytes)
+{
+	const uint8_t *p = (const uint8_t *) data;
+	uint32_t poly = crc->mode & CRC_MODE_POLY_BITMASK;
+	const uint32_t *table = crcTable[poly];
+	uint32_t top = crcWidth[poly] - 4;
+	uint32_t mask = getMask(poly);
+	uint32_t xorIn = (crc->mode & CRC_MODE_WRDATA_CMPL) ? 0xFF : 0;
+	uint32_t sum = crc->sum;
+	uint32_t b;
+
+	while (bytes--) {
+		b = *p++;
+		if (crc->mode & CRC_MODE_WRDATA_BIT_RVS) {
+			b = reverse8(b);
+		}
+		sum ^= (b ^ xorIn) << (top - 4);
+		sum = ((sum << 4) ^ table[(sum >> top) & 0xF]) & mask;
+		sum = ((sum << 4) ^ table[(sum >> top) & 0xF]) & mask;
+	}
+	crc->sum = sum;
+}
+
+/* Get the checksum of a software CRC */
+uint32_t Chip_CRC_SWSum(const CRC_SW_T *crc)
+{
+	uint32_t poly = crc->mode & CRC_MODE_POLY_BITMASK;
+	uint32_t sum = crc->sum;
+	uint32_t rev, i;
+
+	if (crc->mode & CRC_MODE_SUM_BIT_RVS) {
+		rev = 0;
+		for (i = 0; i < crcWidth[poly]; i += 8) {
+			rev = (rev << 8) | reverse8(sum >> i);
+		}
+		sum = rev;
+	}
+	if (crc->mode & CRC_MODE_SUM_CMPL) {
+		sum = ~sum & getMask(poly);
+	}
+
+	return sum;
+}
+
+#if defined(CORE_M0)
+/* Initialize the CRC engine */
+void Chip_CRC_Init(void)
+{
+	Chip_Clock_EnablePeriphClock(SYSCTL_CLOCK_CRC);
+}
+
+/* Shutdown the CRC engine */
+void Chip_CRC_DeInit(void)
+{
+	Chip_Clock_DisablePeriphClock(SYSCTL_CLOCK_CRC);
+}
+
+/* Select a polynomial with its default options and seed */
+void Chip_CRC_UseDefaultConfig(CRC_POLY_T poly)
+{
+	uint32_t flags, seed;
+
+	getDefaultConfig(poly, &flags, &seed);
+	Chip_CRC_SetPoly(poly, flags);
+	Chip_CRC_SetSeed(seed);
+}
+
+/* Feed a byte stream */
+void Chip_CRC_Update(const void *data, uint32_t bytes)
+{
+	const uint8_t *p = (const uint8_t *) data;
+
+	while (bytes && ((uint32_t) p & 3)) {
+		LPC_CRC->WRDATA8 = *p++;
+		bytes--;
+	}
+	/* The engine takes the most significant byte of a word first */
+	while (bytes >= 4) {
+		LPC_CRC->WRDATA32 = __REV(*(const uint32_t *) p);
+		p += 4;
+		bytes -= 4;
+	}
+	while (bytes--) {
+		LPC_CRC->WRDATA8 = *p++;
+	}
+}
+
+/* Feed a byte stream with DMA */
+Status Chip_CRC_UpdateDMA(const void *data, uint32_t bytes, CRC_DMA_CALLBACK_T callback)
+{
+	if (crcDMA.busy) {
+		return ERROR;
+	}
+
+	crcDMA.callback = callback;
+	crcDMA.next = (const uint8_t *) data;
+	crcDMA.left = bytes;
+	if (bytes == 0) {
+		if (callback) {
+			callback(SUCCESS);
+		}
+		return SUCCESS;
+	}
+	crcDMA.busy = true;
+
+	Chip_DMA_SetCallback(CRC_DMA_CHANNEL, CRC_DMACallback);
+	CRC_DMASendChunk();
+
+	return SUCCESS;
+}
+
+/* Check if a DMA feed is in progress */
+bool Chip_CRC_IsDMABusy(void)
+{
+	return crcDMA.busy;
+}
+
+/* CRC of a byte block */
+uint32_t Chip_CRC_CRC8(const uint8_t *data, uint32_t bytes)
+{
+	Chip_CRC_SetSeed(Chip_CRC_GetSeed());
+	Chip_CRC_Update(data, bytes);
+
+	return Chip_CRC_Sum();
+}
+
+/* CRC of a halfword block */
+uint32_t Chip_CRC_CRC16(const uint16_t *data, uint32_t hwords)
+{
+	Chip_CRC_SetSeed(Chip_CRC_GetSeed());
+	while (hwords--) {
+		LPC_CRC->WRDATA16 = *data++;
+	}
+
+	return Chip_CRC_Sum();
+}
+
+/* CRC of a word block */
+uint32_t Chip_CRC_CRC32(const uint32_t *data, uint32_t words)
+{
+	Chip_CRC_SetSeed(Chip_CRC_GetSeed());
+	while (words--) {
+		LPC_CRC->WRDATA32 = *data++;
+	}
+
+	return Chip_CRC_Sum();
+}
+#endif /* defined(CORE_M0) */
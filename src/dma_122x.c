@@ -0,0 +1,333 @@
+/*
+ * @brief LPC122x micro DMA (PL230) chip driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2012
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "chip.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define DMA_ALL_CHANNELS    ((1 << DMA_CHANNEL_NUM) - 1)
+
+/* Channel control table. The alternate descriptors start DMA_TABLE_ENTRIES
+   entries after the primary ones, only the entries of the implemented
+   channels are allocated. */
+#define DMA_TABLE_SIZE      (DMA_TABLE_ENTRIES + DMA_CHANNEL_NUM)
+#if defined(__CC_ARM)
+__align(DMA_TABLE_ALIGN) STATIC DMA_CHDESC_T dmaTable[DMA_TABLE_SIZE];
+#elif defined(__ICCARM__)
+#pragma data_alignment=DMA_TABLE_ALIGN
+STATIC DMA_CHDESC_T dmaTable[DMA_TABLE_SIZE];
+#else
+STATIC DMA_CHDESC_T dmaTable[DMA_TABLE_SIZE] __attribute__ ((aligned(DMA_TABLE_ALIGN)));
+#endif
+
+/* Channel callbacks */
+STATIC DMA_CALLBACK_T dmaCallback[DMA_CHANNEL_NUM];
+
+/* Cycle type of the primary descriptor of each started channel,
+   DMA_CTRL_CYCLE_STOP when the channel is idle */
+STATIC volatile uint8_t dmaMode[DMA_CHANNEL_NUM];
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Get the address of the last item of a transfer */
+STATIC uint32_t getEndAddr(const volatile void *start, uint32_t inc, uint32_t count)
+{
+	if (inc == 3) {
+		/* No increment */
+		return (uint32_t) start;
+	}
+	return (uint32_t) start + ((count - 1) << inc);
+}
+
+/* Call the callback of a channel */
+STATIC void notifyChannel(DMA_CHID_T ch, DMA_EVENT_T event)
+{
+	if (dmaCallback[ch] != NULL) {
+		dmaCallback[ch](ch, event);
+	}
+}
+
+/* Set or clear channel interrupt enables. The register is updated from
+   thread context and from the DMA interrupt. */
+STATIC void setIrqEnable(LPC_DMA_T *pDMA, uint32_t mask, bool enable)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	if (enable) {
+		pDMA->CHNL_IRQ_ENABLE |= mask;
+	}
+	else {
+		pDMA->CHNL_IRQ_ENABLE &= ~mask;
+	}
+	if (!primask) {
+		__enable_irq();
+	}
+}
+
+/* Enable a channel whose primary descriptor has been set up */
+STATIC void startChannel(LPC_DMA_T *pDMA, DMA_CHID_T ch)
+{
+	uint32_t mask = (1 << ch);
+	uint32_t cycle = dmaTable[ch].ctrl & DMA_CTRL_CYCLE_MASK;
+
+	dmaMode[ch] = (uint8_t) cycle;
+	pDMA->CHNL_PRI_ALT_CLR = mask;
+	pDMA->CHNL_IRQ_STATUS = mask;
+	setIrqEnable(pDMA, mask, true);
+	pDMA->CHNL_ENABLE_SET = mask;
+
+	/* Memory cycles are not paced by a peripheral */
+	if ((cycle == DMA_CTRL_CYCLE_AUTO) || (cycle == DMA_CTRL_CYCLE_MEM_SG_PRI)) {
+		pDMA->CHNL_SW_REQUEST = mask;
+	}
+}
+
+/* Handle the completion of a ping-pong half. The descriptor that completed
+   first is the one the controller is currently pointing at again. */
+STATIC void pingPongDone(LPC_DMA_T *pDMA, DMA_CHID_T ch)
+{
+	DMA_CHDESC_T *pDesc[2] = {&dmaTable[ch], &dmaTable[ch + DMA_TABLE_ENTRIES]};
+	int first = Chip_DMA_IsAltActive(pDMA, ch) ? 1 : 0;
+	int i, half;
+
+	for (i = 0; i < 2; i++) {
+		half = first ^ i;
+		if ((pDesc[half]->ctrl & DMA_CTRL_CYCLE_MASK) == DMA_CTRL_CYCLE_STOP) {
+			notifyChannel(ch, (half == 0) ? DMA_EVENT_PRI_DONE : DMA_EVENT_ALT_DONE);
+		}
+	}
+
+	/* The controller stops on a descriptor that was not re-armed in time,
+	   resume once the callback has handed it back */
+	half = Chip_DMA_IsAltActive(pDMA, ch) ? 1 : 0;
+	if ((dmaMode[ch] == DMA_CTRL_CYCLE_PINGPONG) && !Chip_DMA_IsChannelEnabled(pDMA, ch) &&
+		((pDesc[half]->ctrl & DMA_CTRL_CYCLE_MASK) != DMA_CTRL_CYCLE_STOP)) {
+		Chip_DMA_EnableChannel(pDMA, ch);
+	}
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Initialize the DMA controller */
+void Chip_DMA_Init(LPC_DMA_T *pDMA)
+{
+	Chip_Clock_EnablePeriphClock(SYSCTL_CLOCK_DMA);
+	Chip_DMA_Setup(pDMA);
+}
+
+/* Set up the DMA controller registers and the descriptor table */
+void Chip_DMA_Setup(LPC_DMA_T *pDMA)
+{
+	int i;
+
+	pDMA->CFG = 0;
+	pDMA->CHNL_ENABLE_CLR = DMA_ALL_CHANNELS;
+	pDMA->CHNL_IRQ_ENABLE = 0;
+	pDMA->CHNL_IRQ_STATUS = DMA_ALL_CHANNELS;
+	pDMA->ERR_CLR = 1;
+	pDMA->CHNL_PRI_ALT_CLR = DMA_ALL_CHANNELS;
+	pDMA->CHNL_REQ_MASK_CLR = DMA_ALL_CHANNELS;
+	pDMA->CHNL_USEBURST_CLR = DMA_ALL_CHANNELS;
+	pDMA->CHNL_PRIORITY_CLR = DMA_ALL_CHANNELS;
+
+	for (i = 0; i < DMA_TABLE_SIZE; i++) {
+		dmaTable[i].ctrl = DMA_CTRL_CYCLE_STOP;
+		dmaTable[i].reload = DMA_CTRL_CYCLE_STOP;
+	}
+	for (i = 0; i < DMA_CHANNEL_NUM; i++) {
+		dmaMode[i] = DMA_CTRL_CYCLE_STOP;
+		dmaCallback[i] = NULL;
+	}
+
+	pDMA->CTRL_BASE_PTR = (uint32_t) dmaTable;
+	pDMA->IRQ_ERR_ENABLE = 1;
+	pDMA->CFG = DMA_CFG_MASTER_EN;
+}
+
+/* De-initialize the DMA controller */
+void Chip_DMA_DeInit(LPC_DMA_T *pDMA)
+{
+	pDMA->CHNL_ENABLE_CLR = DMA_ALL_CHANNELS;
+	pDMA->CHNL_IRQ_ENABLE = 0;
+	pDMA->IRQ_ERR_ENABLE = 0;
+	pDMA->CFG = 0;
+	Chip_Clock_DisablePeriphClock(SYSCTL_CLOCK_DMA);
+}
+
+/* Get a channel descriptor */
+DMA_CHDESC_T *Chip_DMA_GetDesc(DMA_CHID_T ch, bool alt)
+{
+	return &dmaTable[alt ? (ch + DMA_TABLE_ENTRIES) : ch];
+}
+
+/* Fill in a channel descriptor */
+Status Chip_DMA_SetupDesc(DMA_CHDESC_T *pDesc, uint32_t ctrl, const volatile void *src,
+						  volatile void *dst, uint32_t count)
+{
+	if ((count == 0) || (count > DMA_MAX_XFER)) {
+		return ERROR;
+	}
+
+	ctrl = (ctrl & ~DMA_CTRL_N_MINUS_1_MASK) | DMA_CTRL_N_MINUS_1(count);
+	pDesc->srcEnd = getEndAddr(src, (ctrl >> 26) & 0x3, count);
+	pDesc->dstEnd = getEndAddr(dst, (ctrl >> 30) & 0x3, count);
+	pDesc->reload = ctrl;
+	pDesc->ctrl = ctrl;
+
+	return SUCCESS;
+}
+
+/* Register the completion callback of a channel */
+void Chip_DMA_SetCallback(DMA_CHID_T ch, DMA_CALLBACK_T callback)
+{
+	dmaCallback[ch] = callback;
+}
+
+/* Start a basic or auto-request transfer on a channel */
+Status Chip_DMA_Transfer(LPC_DMA_T *pDMA, DMA_CHID_T ch, uint32_t ctrl, const volatile void *src,
+						 volatile void *dst, uint32_t count)
+{
+	if ((ctrl & DMA_CTRL_CYCLE_MASK) != DMA_CTRL_CYCLE_AUTO) {
+		ctrl = (ctrl & ~DMA_CTRL_CYCLE_MASK) | DMA_CTRL_CYCLE_BASIC;
+	}
+	if (Chip_DMA_SetupDesc(&dmaTable[ch], ctrl, src, dst, count) == ERROR) {
+		return ERROR;
+	}
+
+	startChannel(pDMA, ch);
+	return SUCCESS;
+}
+
+/* Start a ping-pong transfer on a channel */
+Status Chip_DMA_PingPong(LPC_DMA_T *pDMA, DMA_CHID_T ch, uint32_t ctrl, const volatile void *const src[2],
+						 volatile void *const dst[2], uint32_t count)
+{
+	ctrl = (ctrl & ~DMA_CTRL_CYCLE_MASK) | DMA_CTRL_CYCLE_PINGPONG;
+	if ((Chip_DMA_SetupDesc(&dmaTable[ch], ctrl, src[0], dst[0], count) == ERROR) ||
+		(Chip_DMA_SetupDesc(&dmaTable[ch + DMA_TABLE_ENTRIES], ctrl, src[1], dst[1], count) == ERROR)) {
+		return ERROR;
+	}
+
+	startChannel(pDMA, ch);
+	return SUCCESS;
+}
+
+/* Start a scatter-gather transfer on a channel */
+Status Chip_DMA_ScatterGather(LPC_DMA_T *pDMA, DMA_CHID_T ch, DMA_CHDESC_T *pTasks,
+							  uint32_t numTasks, bool periph)
+{
+	DMA_CHDESC_T *pAlt = &dmaTable[ch + DMA_TABLE_ENTRIES];
+	uint32_t i, cycle;
+
+	if ((numTasks == 0) || (numTasks > (DMA_MAX_XFER / 4))) {
+		return ERROR;
+	}
+
+	/* Chain the tasks, the last one ends the cycle */
+	for (i = 0; i < numTasks; i++) {
+		if (i == (numTasks - 1)) {
+			cycle = periph ? DMA_CTRL_CYCLE_BASIC : DMA_CTRL_CYCLE_AUTO;
+		}
+		else {
+			cycle = periph ? DMA_CTRL_CYCLE_PER_SG_ALT : DMA_CTRL_CYCLE_MEM_SG_ALT;
+		}
+		pTasks[i].reload = (pTasks[i].reload & ~DMA_CTRL_CYCLE_MASK) | cycle;
+		pTasks[i].ctrl = pTasks[i].reload;
+	}
+
+	/* The primary descriptor copies each task into the alternate descriptor,
+	   4 words per arbitration */
+	cycle = periph ? DMA_CTRL_CYCLE_PER_SG_PRI : DMA_CTRL_CYCLE_MEM_SG_PRI;
+	Chip_DMA_SetupDesc(&dmaTable[ch], cycle | DMA_XFER_MEM2MEM_32, pTasks, pAlt, numTasks * 4);
+	dmaTable[ch].dstEnd = (uint32_t) &pAlt->reload;
+
+	startChannel(pDMA, ch);
+	return SUCCESS;
+}
+
+/* Stop a channel */
+void Chip_DMA_Abort(LPC_DMA_T *pDMA, DMA_CHID_T ch)
+{
+	uint32_t mask = (1 << ch);
+
+	setIrqEnable(pDMA, mask, false);
+	pDMA->CHNL_ENABLE_CLR = mask;
+	pDMA->CHNL_IRQ_STATUS = mask;
+	dmaMode[ch] = DMA_CTRL_CYCLE_STOP;
+}
+
+/* DMA interrupt handler */
+void Chip_DMA_IRQHandler(LPC_DMA_T *pDMA)
+{
+	uint32_t done = pDMA->CHNL_IRQ_STATUS & pDMA->CHNL_IRQ_ENABLE;
+	uint32_t err = pDMA->ERR_CLR & 1;
+	uint32_t mask;
+	int ch;
+
+	pDMA->CHNL_IRQ_STATUS = done;
+	if (err) {
+		pDMA->ERR_CLR = err;
+	}
+
+	for (ch = 0; ((done | err) != 0) && (ch < DMA_CHANNEL_NUM); ch++) {
+		mask = (1 << ch);
+
+		if (done & mask) {
+			done &= ~mask;
+			if (dmaMode[ch] == DMA_CTRL_CYCLE_PINGPONG) {
+				pingPongDone(pDMA, (DMA_CHID_T) ch);
+			}
+			else {
+				dmaMode[ch] = DMA_CTRL_CYCLE_STOP;
+				notifyChannel((DMA_CHID_T) ch, DMA_EVENT_PRI_DONE);
+			}
+		}
+		else if (err && (dmaMode[ch] != DMA_CTRL_CYCLE_STOP) && !Chip_DMA_IsChannelEnabled(pDMA, (DMA_CHID_T) ch)) {
+			/* The controller does not report which channel faulted, it
+			   disables it. Fail every started channel that went idle
+			   without completing. */
+			dmaMode[ch] = DMA_CTRL_CYCLE_STOP;
+			setIrqEnable(pDMA, mask, false);
+			notifyChannel((DMA_CHID_T) ch, DMA_EVENT_ERROR);
+		}
+	}
+}
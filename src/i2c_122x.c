@@ -29,6 +29,7 @@
  * this code.
  */
 
+#include <string.h>
 #include "chip.h"
 
 /*****************************************************************************
@@ -39,6 +40,11 @@
 #define I2C_CON_FLAGS (I2C_CON_AA | I2C_CON_SI | I2C_CON_STO | I2C_CON_STA)
 #define LPC_I2Cx(id)      ((i2c[id].ip))
 #define SLAVE_ACTIVE(iic) (((iic)->flags & 0xFF00) != 0)
+#define FLAG_BUS_HELD     (1 << 0)	/* Bus held after a transfer without STOP */
+#define FLAG_IRQ_MASKED   (1 << 1)	/* I2C interrupt masked while the bus is held */
+#define RECOVER_HALF_US   5			/* Half period of the recovery clock, 100 KHz */
+#define BACKOFF_MAX_SHIFT 8			/* Retry delay stops doubling after this many retries */
+#define REG_STATE_PTR     (1 << 0)	/* Next byte written by the master sets the register pointer */
 
 /* I2C common interface structure */
 struct i2c_interface {
@@ -49,21 +55,42 @@ struct i2c_interface {
 	I2C_XFER_T *mXfer;	/* Current active xfer pointer */
 	I2C_XFER_T *sXfer;	/* Pointer to store xfer when bus is busy */
 	uint32_t flags;		/* Flags used by I2C master and slave */
+	I2C_JOB_T *mJob;	/* Active asynchronous master job, head of the job queue */
+	I2C_JOB_T *mJobTail;	/* Last queued asynchronous master job */
+	LPC_TIMER_T *pTimer;	/* Transfer timeout timer, NULL if not used */
+	int retries;		/* Retries of the blocking master functions */
+	uint32_t backoffUs;	/* Delay before the first retry */
+	I2C_REGFILE_T *sRegs;	/* Register file of the active slave, NULL for an event slave */
 };
 
 /* Slave interface structure */
 struct i2c_slave_interface {
 	I2C_XFER_T *xfer;
 	I2C_EVENTHANDLER_T event;
+	I2C_REGFILE_T *regFile;
 };
 
 /* I2C interfaces */
 static struct i2c_interface i2c[I2C_NUM_INTERFACE] = {
-	{LPC_I2C, SYSCTL_CLOCK_I2C, Chip_I2C_EventHandler, NULL, NULL, NULL, 0}
+	{LPC_I2C, SYSCTL_CLOCK_I2C, Chip_I2C_EventHandler, NULL, NULL, NULL, 0, NULL, NULL, NULL,
+	 I2C_RETRY_DEFAULT, I2C_BACKOFF_DEFAULT, NULL}
 };
 
 static struct i2c_slave_interface i2c_slave[I2C_NUM_INTERFACE][I2C_SLAVE_NUM_INTERFACE];
 
+/* Maximum rate and minimum SCL low and high times of each bus mode, in ns */
+static const struct {
+	uint32_t maxRate;
+	uint16_t lowNs;
+	uint16_t highNs;
+} busTiming[] = {
+	{100000, 4700, 4000},	/* I2C_BUS_STANDARD */
+	{400000, 1300, 600},	/* I2C_BUS_FAST */
+	{1000000, 500, 260},	/* I2C_BUS_FASTPLUS */
+};
+
+#define SCL_MIN_COUNT     4			/* Smallest SCLH and SCLL values */
+
 /*****************************************************************************
  * Public types/enumerations/variables
  ****************************************************************************/
@@ -82,10 +109,17 @@ STATIC INLINE void disableClk(I2C_ID_T id)
 	Chip_Clock_DisablePeriphClock(i2c[id].clk);
 }
 
-/* Get the ADC Clock Rate */
+/* Get the I2C Clock Rate, the system clock */
 STATIC INLINE uint32_t getClkRate(I2C_ID_T id)
 {
-	return Chip_Clock_GetMainClockRate();
+	(void) id;
+	return Chip_Clock_GetSystemClockRate();
+}
+
+/* Number of clocks covering a time in ns, rounded up */
+STATIC INLINE uint32_t nsToClocks(uint32_t clkin, uint32_t ns)
+{
+	return (uint32_t) ((((uint64_t) clkin * ns) + 999999999) / 1000000000);
 }
 
 /* Enable I2C and start master transfer */
@@ -108,6 +142,121 @@ STATIC INLINE void startSlaverXfer(LPC_I2C_T *pI2C)
 	pI2C->CONSET = I2C_CON_I2EN | I2C_CON_AA;
 }
 
+/* Start a master transfer, with a repeated START if the bus is still held
+   by a transfer that ended without STOP */
+STATIC void startMaster(I2C_ID_T id)
+{
+	struct i2c_interface *iic = &i2c[id];
+
+	if (!(iic->flags & FLAG_BUS_HELD)) {
+		startMasterXfer(iic->ip);
+		return;
+	}
+
+	/* Set STA before releasing SI, so that no data byte is sent */
+	iic->ip->CONSET = I2C_CON_STA;
+	iic->ip->CONCLR = I2C_CON_SI;
+	if (iic->flags & FLAG_IRQ_MASKED) {
+		NVIC_EnableIRQ(I2C0_IRQn);
+	}
+	iic->flags &= ~(FLAG_BUS_HELD | FLAG_IRQ_MASKED);
+}
+
+/* Mask the interrupt while a transfer without STOP holds the bus, SI stays
+   set until the next transfer is started */
+STATIC void holdBus(I2C_ID_T id)
+{
+	struct i2c_interface *iic = &i2c[id];
+
+	if (!(iic->ip->CONSET & I2C_CON_SI)) {
+		return;
+	}
+
+	iic->flags |= FLAG_BUS_HELD;
+	if (NVIC->ISER[0] & (1UL << I2C0_IRQn)) {
+		NVIC_DisableIRQ(I2C0_IRQn);
+		iic->flags |= FLAG_IRQ_MASKED;
+	}
+}
+
+/* Load the current message segment of a transfer */
+STATIC void loadMsgSegment(I2C_XFER_T *xfer)
+{
+	const I2C_MSG_T *msg = xfer->msgs;
+
+	xfer->slaveAddr = msg->slaveAddr;
+	if (msg->flags & I2C_MSG_RD) {
+		xfer->txSz = 0;
+		xfer->rxBuff = msg->buf;
+		xfer->rxSz = msg->len;
+	}
+	else {
+		xfer->txBuff = msg->buf;
+		xfer->txSz = msg->len;
+		xfer->rxSz = 0;
+	}
+}
+
+/* Select the plain or the message segment mode of a transfer. Only a
+   transfer set up by Chip_I2C_SetupMsgXfer() uses the segments, other
+   callers may leave msgs and numMsgs uninitialized. */
+STATIC void prepareXfer(I2C_XFER_T *xfer)
+{
+	if (xfer->slaveAddr == I2C_XFER_MSGS) {
+		loadMsgSegment(xfer);
+	}
+	else {
+		xfer->msgs = NULL;
+		xfer->numMsgs = 0;
+	}
+}
+
+/* Busy wait for at least the given time */
+STATIC void delayUs(uint32_t us)
+{
+	volatile uint32_t loops = (((Chip_Clock_GetSystemClockRate() + 999999) / 1000000) * us + 3) / 4;
+
+	while (loops--) {}
+}
+
+/* Restart the transfer timeout */
+STATIC void startTimeout(I2C_ID_T id)
+{
+	LPC_TIMER_T *pTimer = i2c[id].pTimer;
+
+	if (pTimer) {
+		pTimer->TCR = 0;
+		pTimer->PC = 0;
+		pTimer->TC = 0;
+		Chip_TIMER_ClearMatch(pTimer, 0);
+		pTimer->TCR = TIMER_ENABLE;
+	}
+}
+
+/* Stop the transfer timeout */
+STATIC void stopTimeout(I2C_ID_T id)
+{
+	LPC_TIMER_T *pTimer = i2c[id].pTimer;
+
+	if (pTimer) {
+		pTimer->TCR = 0;
+		Chip_TIMER_ClearMatch(pTimer, 0);
+	}
+}
+
+/* Release (high) or pull low an I2C line used as GPIO, the output latch
+   stays low so that the pin behaves like an open-drain output */
+STATIC INLINE void setRecoverLine(uint8_t pin, bool high)
+{
+	if (high) {
+		Chip_GPIO_SetPinDIRInput(LPC_GPIO, I2C_GPIO_PORT, pin);
+	}
+	else {
+		Chip_GPIO_SetPinDIROutput(LPC_GPIO, I2C_GPIO_PORT, pin);
+	}
+	delayUs(RECOVER_HALF_US);
+}
+
 /* Check if I2C bus is free */
 STATIC INLINE int isI2CBusFree(LPC_I2C_T *pI2C)
 {
@@ -170,12 +319,15 @@ STATIC I2C_SLAVE_ID lookupSlaveIndex(LPC_I2C_T *pI2C, uint8_t slaveAddr)
 	return I2C_SLAVE_GENERAL;
 }
 
-/* Master transfer state change handler handler */
-int handleMasterXferState(LPC_I2C_T *pI2C, I2C_XFER_T  *xfer)
+/* Master transfer state change handler handler, when chain is set the
+   transfer ends with a (repeated) START for the next transfer */
+int handleMasterXferState(LPC_I2C_T *pI2C, I2C_XFER_T  *xfer, int chain)
 {
 	uint32_t cclr = I2C_CON_FLAGS;
+	int state = getCurState(pI2C);
+	int done;
 
-	switch (getCurState(pI2C)) {
+	switch (state) {
 	case 0x08:		/* Start condition on bus */
 	case 0x10:		/* Repeated start condition */
 		pI2C->DAT = (xfer->slaveAddr << 1) | (xfer->txSz == 0);
@@ -225,12 +377,48 @@ int handleMasterXferState(LPC_I2C_T *pI2C, I2C_XFER_T  *xfer)
 		cclr &= ~I2C_CON_STO;
 	}
 
+	/* Move on to the next message segment instead of stopping */
+	if ((xfer->status == I2C_STATUS_BUSY) && !(cclr & I2C_CON_STO) && (xfer->numMsgs > 1)) {
+		xfer->msgs++;
+		xfer->numMsgs--;
+		loadMsgSegment(xfer);
+		cclr |= I2C_CON_STO;
+
+		if (((xfer->msgs->flags & (I2C_MSG_NOSTART | I2C_MSG_RD)) == I2C_MSG_NOSTART) &&
+			(xfer->txSz > 0) && ((state == 0x18) || (state == 0x28))) {
+			/* Continue writing without a repeated START */
+			pI2C->DAT = *xfer->txBuff++;
+			xfer->txSz--;
+		}
+		else {
+			cclr &= ~I2C_CON_STA;
+		}
+	}
+
+	done = !(cclr & I2C_CON_STO) || (xfer->status == I2C_STATUS_ARBLOST);
+	if (done && !chain && (xfer->status == I2C_STATUS_BUSY) && (xfer->numMsgs > 0) &&
+		(xfer->msgs->flags & I2C_MSG_NOSTOP)) {
+		/* Keep the bus: leave SI set, without STOP the clock is held low
+		   until the next transfer sets STA */
+		pI2C->CONCLR = I2C_CON_STA | I2C_CON_AA;
+		xfer->status = I2C_STATUS_DONE;
+		return 0;
+	}
+	if (done && chain) {
+		/* Keep the bus with a repeated START after a successful transfer,
+		   otherwise START again after the STOP or once the bus is free */
+		if (xfer->status == I2C_STATUS_BUSY) {
+			cclr |= I2C_CON_STO;
+		}
+		cclr &= ~I2C_CON_STA;
+	}
+
 	/* Set clear control flags */
 	pI2C->CONSET = cclr ^ I2C_CON_FLAGS;
 	pI2C->CONCLR = cclr;
 
 	/* If stopped return 0 */
-	if (!(cclr & I2C_CON_STO) || (xfer->status == I2C_STATUS_ARBLOST)) {
+	if (done) {
 		if (xfer->status == I2C_STATUS_BUSY) {
 			xfer->status = I2C_STATUS_DONE;
 		}
@@ -239,6 +427,110 @@ int handleMasterXferState(LPC_I2C_T *pI2C, I2C_XFER_T  *xfer)
 	return 1;
 }
 
+/* Abort the active master transfer after a timeout and recover the bus */
+STATIC void abortMaster(I2C_ID_T id)
+{
+	struct i2c_interface *iic = &i2c[id];
+	I2C_JOB_T *job = iic->mJob;
+	int irqOn = (iic->flags & FLAG_IRQ_MASKED) || (NVIC->ISER[0] & (1UL << I2C0_IRQn));
+
+	NVIC_DisableIRQ(I2C0_IRQn);
+	iic->flags &= ~(FLAG_BUS_HELD | FLAG_IRQ_MASKED);
+	Chip_I2C_RecoverBus(id);
+
+	if (job) {
+		job->xfer.status = I2C_STATUS_TIMEOUT;
+		iic->mJob = job->next;
+		if (iic->mJob) {
+			iic->mXfer = &iic->mJob->xfer;
+			startMaster(id);
+			startTimeout(id);
+		}
+		else {
+			iic->mJobTail = NULL;
+			iic->mXfer = NULL;
+			if (SLAVE_ACTIVE(iic)) {
+				startSlaverXfer(iic->ip);
+			}
+		}
+		job->next = NULL;
+	}
+	else if (iic->mXfer && (iic->mXfer->status == I2C_STATUS_BUSY)) {
+		iic->mXfer->status = I2C_STATUS_TIMEOUT;
+		iic->mEvent(id, I2C_EVENT_DONE);
+	}
+
+	NVIC_ClearPendingIRQ(I2C0_IRQn);
+	if (irqOn) {
+		NVIC_EnableIRQ(I2C0_IRQn);
+	}
+	if (job && job->callback) {
+		job->callback(id, job);
+	}
+}
+
+/* Blocking master transfer, retried with an increasing delay after an
+   arbitration loss, a bus error or a timeout */
+STATIC int masterTransferRetry(I2C_ID_T id, I2C_XFER_T *xfer)
+{
+	struct i2c_interface *iic = &i2c[id];
+	I2C_XFER_T first = *xfer;
+	int attempt = 0;
+	int status;
+
+	while (1) {
+		status = Chip_I2C_MasterTransfer(id, xfer);
+		if (((status != I2C_STATUS_ARBLOST) && (status != I2C_STATUS_BUSERR) &&
+			 (status != I2C_STATUS_TIMEOUT)) || (attempt >= iic->retries)) {
+			return status;
+		}
+
+		if (status == I2C_STATUS_BUSERR) {
+			Chip_I2C_RecoverBus(id);
+			if (SLAVE_ACTIVE(iic)) {
+				startSlaverXfer(iic->ip);
+			}
+		}
+		delayUs(iic->backoffUs << MIN(attempt, BACKOFF_MAX_SHIFT));
+		attempt++;
+		*xfer = first;
+	}
+}
+
+/* Asynchronous master job state handler */
+STATIC void handleMasterJobState(I2C_ID_T id)
+{
+	struct i2c_interface *iic = &i2c[id];
+	I2C_JOB_T *job = iic->mJob;
+
+	if (handleMasterXferState(iic->ip, &job->xfer, job->next != NULL)) {
+		return;
+	}
+
+	/* The next job, if any, has already been started on the bus */
+	iic->mJob = job->next;
+	if (!iic->mJob) {
+		iic->mJobTail = NULL;
+		iic->mXfer = NULL;
+		stopTimeout(id);
+		holdBus(id);
+
+		/* Resume slave operation once the STOP is sent */
+		if (SLAVE_ACTIVE(iic) && !(iic->flags & FLAG_BUS_HELD)) {
+			iic->ip->CONSET = I2C_CON_AA;
+		}
+	}
+	else {
+		iic->mXfer = &iic->mJob->xfer;
+		startTimeout(id);
+	}
+
+	job->next = NULL;
+	if (job->callback) {
+		job->callback(id, job);
+	}
+}
+
 /* Find the slave address of SLA+W or SLA+R */
 I2C_SLAVE_ID getSlaveIndex(LPC_I2C_T *pI2C)
 {
@@ -318,6 +610,127 @@ int handleSlaveXferState(LPC_I2C_T *pI2C, I2C_XFER_T *xfer)
 	return ret;
 }
 
+/* Find the register holding a register address */
+STATIC const I2C_REG_T *lookupReg(const I2C_REGFILE_T *rf, uint8_t addr)
+{
+	int i;
+
+	for (i = 0; i < rf->numRegs; i++) {
+		if ((uint8_t) (addr - rf->regs[i].addr) < rf->regs[i].size) {
+			return &rf->regs[i];
+		}
+	}
+	return NULL;
+}
+
+/* Enter the register at the register pointer, the master reads a copy
+   taken on entry and writes are collected in the same buffer */
+STATIC const I2C_REG_T *enterReg(I2C_REGFILE_T *rf)
+{
+	const I2C_REG_T *reg = lookupReg(rf, rf->ptr);
+
+	if (reg != rf->cur) {
+		rf->cur = reg;
+		rf->written = 0;
+		if (reg) {
+			memcpy(rf->buf, reg->data, reg->size);
+		}
+	}
+	return reg;
+}
+
+/* Store the register written by the master to the current register */
+STATIC void commitReg(I2C_ID_T id, I2C_REGFILE_T *rf)
+{
+	const I2C_REG_T *reg = rf->cur;
+	uint8_t mask;
+	int i;
+
+	for (i = 0; i < reg->size; i++) {
+		mask = reg->wrMask ? reg->wrMask[i] : 0xFF;
+		reg->data[i] = (reg->data[i] & ~mask) | (rf->buf[i] & mask);
+	}
+
+	if (reg->commit) {
+		reg->commit(id, reg);
+	}
+}
+
+/* Register file slave state machine handler, returns 1 once the slave
+   transfer is done */
+STATIC int handleSlaveRegState(I2C_ID_T id, I2C_REGFILE_T *rf)
+{
+	LPC_I2C_T *pI2C = i2c[id].ip;
+	uint32_t cclr = I2C_CON_FLAGS & ~I2C_CON_AA;
+	const I2C_REG_T *reg;
+	uint8_t offs;
+	int done = 0;
+
+	switch (getCurState(pI2C)) {
+	case 0x60:		/* Own SLA+W received */
+	case 0x68:		/* Own SLA+W received after losing arbitration */
+	case 0x70:		/* GC+W received */
+	case 0x78:		/* GC+W received after losing arbitration */
+		rf->state = REG_STATE_PTR;
+		rf->cur = NULL;
+		break;
+
+	case 0x80:		/* SLA: Data received + ACK sent */
+	case 0x90:		/* GC: Data received + ACK sent */
+		if (rf->state & REG_STATE_PTR) {
+			rf->ptr = pI2C->DAT;
+			rf->state = 0;
+			break;
+		}
+		reg = enterReg(rf);
+		if (reg && !(reg->flags & I2C_REG_RO)) {
+			offs = rf->ptr - reg->addr;
+			rf->buf[offs] = pI2C->DAT;
+			rf->written |= 1 << offs;
+			if (offs == (reg->size - 1)) {
+				/* A write that started inside the register is dropped */
+				if (rf->written == ((1 << reg->size) - 1)) {
+					commitReg(id, rf);
+				}
+				rf->written = 0;
+			}
+		}
+		rf->ptr++;
+		break;
+
+	case 0xA8:		/* SLA+R received */
+	case 0xB0:		/* SLA+R received after losing arbitration */
+		rf->state = 0;
+		rf->cur = NULL;
+
+	case 0xB8:		/* DATA sent and ACK received */
+		reg = enterReg(rf);
+		pI2C->DAT = reg ? rf->buf[(uint8_t) (rf->ptr - reg->addr)] : 0xFF;
+		rf->ptr++;
+		break;
+
+	case 0xC0:		/* Data transmitted and NAK received */
+	case 0xC8:		/* Last data transmitted and ACK received */
+	case 0x88:		/* SLA: Data received + NAK sent */
+	case 0x98:		/* GC: Data received + NAK sent */
+	case 0xA0:		/* STOP/Repeated START condition received */
+		/* A partially written register is dropped */
+		rf->state = 0;
+		rf->cur = NULL;
+		done = 1;
+		if (i2c[id].mXfer) {
+			cclr &= ~I2C_CON_STA;
+		}
+		break;
+	}
+
+	/* Set clear control flags */
+	pI2C->CONSET = cclr ^ I2C_CON_FLAGS;
+	pI2C->CONCLR = cclr;
+
+	return done;
+}
+
 /*****************************************************************************
  * Public functions
  ****************************************************************************/
@@ -335,7 +748,9 @@ void Chip_I2C_EventHandler(I2C_ID_T id, I2C_EVENT_T event)
 
 	stat = &iic->mXfer->status;
 	/* Wait for the status to change */
-	while (*stat == I2C_STATUS_BUSY) {}
+	while (*stat == I2C_STATUS_BUSY) {
+		Chip_I2C_TimeoutHandler(id);
+	}
 }
 
 /* Chip polling event handler */
@@ -355,6 +770,9 @@ void Chip_I2C_EventHandlerPolling(I2C_ID_T id, I2C_EVENT_T event)
 		if (Chip_I2C_IsStateChanged(id)) {
 			Chip_I2C_MasterStateHandler(id);
 		}
+		else {
+			Chip_I2C_TimeoutHandler(id);
+		}
 	}
 }
 
@@ -379,11 +797,68 @@ void Chip_I2C_DeInit(I2C_ID_T id)
 /* Set up clock rate for LPC_I2C peripheral */
 void Chip_I2C_SetClockRate(I2C_ID_T id, uint32_t clockrate)
 {
-	uint32_t SCLValue;
+	I2C_BUSMODE_T mode = I2C_BUS_STANDARD;
 
-	SCLValue = (getClkRate(id) / clockrate);
-	LPC_I2Cx(id)->SCLH = (uint32_t) (SCLValue >> 1);
-	LPC_I2Cx(id)->SCLL = (uint32_t) (SCLValue - LPC_I2Cx(id)->SCLH);
+	if (clockrate > busTiming[I2C_BUS_FAST].maxRate) {
+		mode = I2C_BUS_FASTPLUS;
+	}
+	else if (clockrate > busTiming[I2C_BUS_STANDARD].maxRate) {
+		mode = I2C_BUS_FAST;
+	}
+	Chip_I2C_SetClockRateMode(id, mode, clockrate, 0);
+}
+
+/* Find the SCLH and SCLL values for a bus mode and rate */
+Status Chip_I2C_CalcClock(uint32_t clkin, I2C_BUSMODE_T mode, uint32_t clockrate, uint32_t riseNs,
+						  I2C_CLOCK_T *pClk)
+{
+	uint32_t low, high, total, extra;
+	uint64_t periodNs;
+
+	if (clockrate > busTiming[mode].maxRate) {
+		clockrate = busTiming[mode].maxRate;
+	}
+	if ((clkin == 0) || (clockrate == 0) || ((uint64_t) riseNs * clockrate >= 1000000000)) {
+		return ERROR;
+	}
+
+	/* Smallest count whose period, rise time included, is not shorter
+	   than the target period: total >= clkin * (1 / clockrate - riseNs) */
+	periodNs = 1000000000 - ((uint64_t) riseNs * clockrate);
+	total = (uint32_t) ((((uint64_t) clkin * periodNs) + ((uint64_t) clockrate * 1000000000) - 1) /
+						((uint64_t) clockrate * 1000000000));
+
+	low = MAX(nsToClocks(clkin, busTiming[mode].lowNs), SCL_MIN_COUNT);
+	high = MAX(nsToClocks(clkin, busTiming[mode].highNs), SCL_MIN_COUNT);
+	if (total > (low + high)) {
+		extra = total - (low + high);
+		low += (uint32_t) (((uint64_t) extra * low) / (low + high));
+		high = total - low;
+	}
+	if ((low > 0xFFFF) || (high > 0xFFFF)) {
+		return ERROR;
+	}
+
+	pClk->scll = (uint16_t) low;
+	pClk->sclh = (uint16_t) high;
+	pClk->clockrate = (uint32_t) (((uint64_t) clkin * 1000000000) /
+								  (((uint64_t) (low + high) * 1000000000) + ((uint64_t) riseNs * clkin)));
+
+	return SUCCESS;
+}
+
+/* Set up a compliant SCL timing for a bus mode */
+uint32_t Chip_I2C_SetClockRateMode(I2C_ID_T id, I2C_BUSMODE_T mode, uint32_t clockrate, uint32_t riseNs)
+{
+	I2C_CLOCK_T clk;
+
+	if (Chip_I2C_CalcClock(getClkRate(id), mode, clockrate, riseNs, &clk) != SUCCESS) {
+		return 0;
+	}
+
+	LPC_I2Cx(id)->SCLH = clk.sclh;
+	LPC_I2Cx(id)->SCLL = clk.scll;
+	return clk.clockrate;
 }
 
 /* Get current clock rate for LPC_I2C peripheral */
@@ -414,21 +889,26 @@ int Chip_I2C_MasterTransfer(I2C_ID_T id, I2C_XFER_T *xfer)
 	struct i2c_interface *iic = &i2c[id];
 
 	iic->mEvent(id, I2C_EVENT_LOCK);
+	prepareXfer(xfer);
 	xfer->status = I2C_STATUS_BUSY;
 	iic->mXfer = xfer;
+	startTimeout(id);
 
 	/* If slave xfer not in progress */
 	if (!iic->sXfer) {
-		startMasterXfer(iic->ip);
+		startMaster(id);
 	}
 	iic->mEvent(id, I2C_EVENT_WAIT);
 	iic->mXfer = 0;
 
 	/* Wait for stop condition to appear on bus */
-	while (!isI2CBusFree(iic->ip)) {}
+	while (!isI2CBusFree(iic->ip)) {
+		Chip_I2C_TimeoutHandler(id);
+	}
+	stopTimeout(id);
 
 	/* Start slave if one is active */
-	if (SLAVE_ACTIVE(iic)) {
+	if (SLAVE_ACTIVE(iic) && !(iic->flags & FLAG_BUS_HELD)) {
 		startSlaverXfer(iic->ip);
 	}
 
@@ -443,7 +923,7 @@ int Chip_I2C_MasterSend(I2C_ID_T id, uint8_t slaveAddr, const uint8_t *buff, uin
 	xfer.slaveAddr = slaveAddr;
 	xfer.txBuff = buff;
 	xfer.txSz = len;
-	while (Chip_I2C_MasterTransfer(id, &xfer) == I2C_STATUS_ARBLOST) {}
+	masterTransferRetry(id, &xfer);
 	return len - xfer.txSz;
 }
 
@@ -458,7 +938,7 @@ int Chip_I2C_MasterCmdRead(I2C_ID_T id, uint8_t slaveAddr, uint8_t cmd, uint8_t
 	xfer.txSz = 1;
 	xfer.rxBuff = buff;
 	xfer.rxSz = len;
-	while (Chip_I2C_MasterTransfer(id, &xfer) == I2C_STATUS_ARBLOST) {}
+	masterTransferRetry(id, &xfer);
 	return len - xfer.rxSz;
 }
 
@@ -469,10 +949,103 @@ int Chip_I2C_MasterRead(I2C_ID_T id, uint8_t slaveAddr, uint8_t *buff, int len)
 	xfer.slaveAddr = slaveAddr;
 	xfer.rxBuff = buff;
 	xfer.rxSz = len;
-	while (Chip_I2C_MasterTransfer(id, &xfer) == I2C_STATUS_ARBLOST) {}
+	masterTransferRetry(id, &xfer);
 	return len - xfer.rxSz;
 }
 
+/* Queue an asynchronous master transfer */
+void Chip_I2C_MasterSubmit(I2C_ID_T id, I2C_JOB_T *job)
+{
+	struct i2c_interface *iic = &i2c[id];
+	uint32_t primask = __get_PRIMASK();
+
+	prepareXfer(&job->xfer);
+	job->xfer.status = I2C_STATUS_BUSY;
+	job->next = NULL;
+
+	/* The queue is also updated from the I2C interrupt */
+	__disable_irq();
+	if (iic->mJob) {
+		iic->mJobTail->next = job;
+		iic->mJobTail = job;
+	}
+	else {
+		iic->mJob = iic->mJobTail = job;
+		iic->mXfer = &job->xfer;
+
+		/* START is sent once a pending STOP is done, if a slave transfer
+		   is in progress the slave handler starts the master instead */
+		if (!iic->sXfer) {
+			startMaster(id);
+		}
+		startTimeout(id);
+	}
+	if (!primask) {
+		__enable_irq();
+	}
+}
+
+/* Check if asynchronous master transfers are queued */
+int Chip_I2C_MasterJobsPending(I2C_ID_T id)
+{
+	return i2c[id].mJob != NULL;
+}
+
+/* Set up a transfer from an array of message segments */
+void Chip_I2C_SetupMsgXfer(I2C_XFER_T *xfer, I2C_MSG_T *msgs, int num)
+{
+	xfer->slaveAddr = I2C_XFER_MSGS;
+	xfer->msgs = msgs;
+	xfer->numMsgs = num;
+}
+
+/* Transfer an array of message segments in master mode */
+int Chip_I2C_MasterTransferMsgs(I2C_ID_T id, I2C_MSG_T *msgs, int num)
+{
+	I2C_XFER_T xfer = {0};
+
+	Chip_I2C_SetupMsgXfer(&xfer, msgs, num);
+	return Chip_I2C_MasterTransfer(id, &xfer);
+}
+
+/* Read from a slave register with an 8 or 16-bit register address */
+int Chip_I2C_MasterReadReg(I2C_ID_T id, uint8_t slaveAddr, uint16_t reg, int regSz, uint8_t *buff, int len)
+{
+	uint8_t regBuf[2] = {(uint8_t) (reg >> 8), (uint8_t) reg};
+	I2C_MSG_T msgs[2] = {
+		{slaveAddr, 0, 0, NULL},
+		{slaveAddr, I2C_MSG_RD, 0, NULL}
+	};
+	I2C_XFER_T xfer = {0};
+
+	msgs[0].buf = (regSz == 2) ? regBuf : &regBuf[1];
+	msgs[0].len = (regSz == 2) ? 2 : 1;
+	msgs[1].buf = buff;
+	msgs[1].len = (uint16_t) len;
+
+	Chip_I2C_SetupMsgXfer(&xfer, msgs, 2);
+	return (masterTransferRetry(id, &xfer) == I2C_STATUS_DONE) ? len : 0;
+}
+
+/* Write to a slave register with an 8 or 16-bit register address */
+int Chip_I2C_MasterWriteReg(I2C_ID_T id, uint8_t slaveAddr, uint16_t reg, int regSz, const uint8_t *buff, int len)
+{
+	uint8_t regBuf[2] = {(uint8_t) (reg >> 8), (uint8_t) reg};
+	I2C_MSG_T msgs[2] = {
+		{slaveAddr, 0, 0, NULL},
+		{slaveAddr, I2C_MSG_NOSTART, 0, NULL}
+	};
+	I2C_XFER_T xfer = {0};
+
+	msgs[0].buf = (regSz == 2) ? regBuf : &regBuf[1];
+	msgs[0].len = (regSz == 2) ? 2 : 1;
+	msgs[1].buf = (uint8_t *) buff;
+	msgs[1].len = (uint16_t) len;
+
+	Chip_I2C_SetupMsgXfer(&xfer, msgs, (len > 0) ? 2 : 1);
+	return (masterTransferRetry(id, &xfer) == I2C_STATUS_DONE) ? len : 0;
+}
+
 /* Check if master state is active */
 int Chip_I2C_IsMasterActive(I2C_ID_T id)
 {
@@ -482,11 +1055,118 @@ int Chip_I2C_IsMasterActive(I2C_ID_T id)
 /* State change handler for master transfer */
 void Chip_I2C_MasterStateHandler(I2C_ID_T id)
 {
-	if (!handleMasterXferState(i2c[id].ip, i2c[id].mXfer)) {
+	if (i2c[id].mJob) {
+		handleMasterJobState(id);
+	}
+	else if (!handleMasterXferState(i2c[id].ip, i2c[id].mXfer, 0)) {
+		holdBus(id);
 		i2c[id].mEvent(id, I2C_EVENT_DONE);
 	}
 }
 
+/* Set up the master transfer timeout */
+Status Chip_I2C_SetTimeout(I2C_ID_T id, LPC_TIMER_T *pTimer, uint32_t timeoutUs)
+{
+	uint64_t ticks;
+	uint32_t prescale;
+
+	stopTimeout(id);
+	i2c[id].pTimer = NULL;
+	if ((pTimer == NULL) || (timeoutUs == 0)) {
+		return SUCCESS;
+	}
+
+	/* Scale the timer so that the timeout also fits a 16-bit timer */
+	ticks = ((uint64_t) Chip_Clock_GetSystemClockRate() * timeoutUs) / 1000000;
+	prescale = (uint32_t) (ticks / 0x10000) + 1;
+	if (prescale > 0x10000) {
+		return ERROR;
+	}
+
+	Chip_TIMER_Init(pTimer);
+	pTimer->TCR = 0;
+	pTimer->CTCR = 0;
+	Chip_TIMER_PrescaleSet(pTimer, prescale - 1);
+	Chip_TIMER_SetMatch(pTimer, 0, MAX((uint32_t) (ticks / prescale), 1));
+	pTimer->MCR = TIMER_INT_ON_MATCH(0) | TIMER_RESET_ON_MATCH(0) | TIMER_STOP_ON_MATCH(0);
+	Chip_TIMER_ClearMatch(pTimer, 0);
+	i2c[id].pTimer = pTimer;
+
+	return SUCCESS;
+}
+
+/* Master transfer timeout handler */
+void Chip_I2C_TimeoutHandler(I2C_ID_T id)
+{
+	LPC_TIMER_T *pTimer = i2c[id].pTimer;
+	uint32_t primask = __get_PRIMASK();
+	bool expired;
+
+	if (!pTimer) {
+		return;
+	}
+
+	/* Also polled by the blocking transfers, only one caller may handle
+	   the expired timeout */
+	__disable_irq();
+	expired = Chip_TIMER_MatchPending(pTimer, 0);
+	Chip_TIMER_ClearMatch(pTimer, 0);
+	if (!primask) {
+		__enable_irq();
+	}
+
+	if (expired) {
+		abortMaster(id);
+	}
+}
+
+/* Free a bus held low by a slave */
+Status Chip_I2C_RecoverBus(I2C_ID_T id)
+{
+	uint32_t sclMode = LPC_IOCON[I2C_SCL_IOCON].REG;
+	uint32_t sdaMode = LPC_IOCON[I2C_SDA_IOCON].REG;
+	Status ret;
+	int i;
+
+	LPC_I2Cx(id)->CONCLR = I2C_CON_I2EN | I2C_CON_SI | I2C_CON_STO | I2C_CON_STA | I2C_CON_AA;
+
+	/* Take over the pins as GPIO, both released */
+	Chip_GPIO_SetPinDIRInput(LPC_GPIO, I2C_GPIO_PORT, I2C_SCL_GPIO_PIN);
+	Chip_GPIO_SetPinDIRInput(LPC_GPIO, I2C_GPIO_PORT, I2C_SDA_GPIO_PIN);
+	Chip_GPIO_SetPinState(LPC_GPIO, I2C_GPIO_PORT, I2C_SCL_GPIO_PIN, false);
+	Chip_GPIO_SetPinState(LPC_GPIO, I2C_GPIO_PORT, I2C_SDA_GPIO_PIN, false);
+	Chip_IOCON_PinMuxSet(LPC_IOCON, I2C_SCL_IOCON, (sclMode & ~0x7) | I2C_GPIO_FUNC);
+	Chip_IOCON_PinMuxSet(LPC_IOCON, I2C_SDA_IOCON, (sdaMode & ~0x7) | I2C_GPIO_FUNC);
+	delayUs(RECOVER_HALF_US);
+
+	/* Clock out the byte the slave is sending, until it releases SDA */
+	for (i = 0; (i < 9) && !Chip_GPIO_GetPinState(LPC_GPIO, I2C_GPIO_PORT, I2C_SDA_GPIO_PIN); i++) {
+		setRecoverLine(I2C_SCL_GPIO_PIN, false);
+		setRecoverLine(I2C_SCL_GPIO_PIN, true);
+	}
+
+	/* STOP condition, SDA rising while SCL is high */
+	setRecoverLine(I2C_SCL_GPIO_PIN, false);
+	setRecoverLine(I2C_SDA_GPIO_PIN, false);
+	setRecoverLine(I2C_SCL_GPIO_PIN, true);
+	setRecoverLine(I2C_SDA_GPIO_PIN, true);
+
+	ret = (Chip_GPIO_GetPinState(LPC_GPIO, I2C_GPIO_PORT, I2C_SCL_GPIO_PIN) &&
+		   Chip_GPIO_GetPinState(LPC_GPIO, I2C_GPIO_PORT, I2C_SDA_GPIO_PIN)) ? SUCCESS : ERROR;
+
+	Chip_IOCON_PinMuxSet(LPC_IOCON, I2C_SCL_IOCON, sclMode);
+	Chip_IOCON_PinMuxSet(LPC_IOCON, I2C_SDA_IOCON, sdaMode);
+
+	return ret;
+}
+
+/* Set the retry policy of the blocking master functions */
+void Chip_I2C_SetRetry(I2C_ID_T id, int retries, uint32_t backoffUs)
+{
+	i2c[id].retries = retries;
+	i2c[id].backoffUs = backoffUs;
+}
+
 /* Setup slave function */
 void Chip_I2C_SlaveSetup(I2C_ID_T id,
 						 I2C_SLAVE_ID sid,
@@ -498,6 +1178,7 @@ void Chip_I2C_SlaveSetup(I2C_ID_T id,
 	struct i2c_slave_interface *si2c = &i2c_slave[id][sid];
 	si2c->xfer = xfer;
 	si2c->event = event;
+	si2c->regFile = NULL;
 
 	/* Set up the slave address */
 	if (sid != I2C_SLAVE_GENERAL) {
@@ -524,6 +1205,15 @@ void Chip_I2C_SlaveStateHandler(I2C_ID_T id)
 		si2c = &i2c_slave[id][sid];
 		iic->sXfer = si2c->xfer;
 		iic->sEvent = si2c->event;
+		iic->sRegs = si2c->regFile;
+	}
+
+	/* Register file slaves are served without events */
+	if (iic->sRegs) {
+		if (handleSlaveRegState(id, iic->sRegs)) {
+			iic->sXfer = 0;
+		}
+		return;
 	}
 
 	iic->sXfer->slaveAddr |= iic->mXfer != 0;
@@ -536,6 +1226,55 @@ void Chip_I2C_SlaveStateHandler(I2C_ID_T id)
 	}
 }
 
+/* Setup a register file slave */
+Status Chip_I2C_SlaveRegSetup(I2C_ID_T id, I2C_SLAVE_ID sid, I2C_REGFILE_T *regFile, uint8_t addrMask)
+{
+	int i;
+
+	for (i = 0; i < regFile->numRegs; i++) {
+		if ((regFile->regs[i].size == 0) || (regFile->regs[i].size > I2C_REG_MAX_SIZE)) {
+			return ERROR;
+		}
+	}
+
+	regFile->cur = NULL;
+	regFile->ptr = 0;
+	regFile->state = 0;
+	regFile->written = 0;
+	regFile->xfer.slaveAddr = regFile->slaveAddr;
+
+	Chip_I2C_SlaveSetup(id, sid, &regFile->xfer, NULL, addrMask);
+	i2c_slave[id][sid].regFile = regFile;
+
+	return SUCCESS;
+}
+
+/* Update the value of a register file register */
+void Chip_I2C_RegUpdate(I2C_ID_T id, const I2C_REG_T *reg, const void *value)
+{
+	int irqOn = (NVIC->ISER[0] & (1UL << I2C0_IRQn)) != 0;
+
+	(void) id;
+	NVIC_DisableIRQ(I2C0_IRQn);
+	memcpy(reg->data, value, reg->size);
+	if (irqOn) {
+		NVIC_EnableIRQ(I2C0_IRQn);
+	}
+}
+
+/* Read the value of a register file register */
+void Chip_I2C_RegRead(I2C_ID_T id, const I2C_REG_T *reg, void *value)
+{
+	int irqOn = (NVIC->ISER[0] & (1UL << I2C0_IRQn)) != 0;
+
+	(void) id;
+	NVIC_DisableIRQ(I2C0_IRQn);
+	memcpy(value, reg->data, reg->size);
+	if (irqOn) {
+		NVIC_EnableIRQ(I2C0_IRQn);
+	}
+}
+
 /* Disable I2C device */
 void Chip_I2C_Disable(I2C_ID_T id)
 {
@@ -36,9 +36,6 @@
  * Private types/enumerations/variables
  ****************************************************************************/
 
-#define RB_INDH(rb)                ((rb)->head & ((rb)->count - 1))
-#define RB_INDT(rb)                ((rb)->tail & ((rb)->count - 1))
-
 /*****************************************************************************
  * Public types/enumerations/variables
  ****************************************************************************/
@@ -47,6 +44,20 @@
  * Private functions
  ****************************************************************************/
 
+/* Split a run of items starting at index into the two wrap segments */
+STATIC int getSpans(RINGBUFF_T *RingBuff, uint32_t index, int num, RINGBUFF_SPAN_T span[2])
+{
+	int idx = index & (RingBuff->count - 1);
+	int cnt1 = MIN(num, RingBuff->count - idx);
+
+	span[0].data = (uint8_t *) RingBuff->data + idx * RingBuff->itemSz;
+	span[0].count = cnt1;
+	span[1].data = RingBuff->data;
+	span[1].count = num - cnt1;
+
+	return num;
+}
+
 /*****************************************************************************
  * Public functions
  ****************************************************************************/
@@ -66,14 +77,21 @@ int RingBuffer_Init(RINGBUFF_T *RingBuff, void *buffer, int itemSize, int count)
 int RingBuffer_Insert(RINGBUFF_T *RingBuff, const void *data)
 {
 	uint8_t *ptr = RingBuff->data;
+	uint32_t head = RingBuff->head;
 
 	/* We cannot insert when queue is full */
-	if (RingBuffer_IsFull(RingBuff))
+	if ((head - RB_VTAIL(RingBuff)) >= (uint32_t) RingBuff->count)
 		return 0;
 
-	ptr += RB_INDH(RingBuff) * RingBuff->itemSz;
+	/* Slot must not be written before the consumer released it */
+	RB_MEMBARRIER();
+
+	ptr += (head & (RingBuff->count - 1)) * RingBuff->itemSz;
 	memcpy(ptr, data, RingBuff->itemSz);
-	RingBuff->head++;
+
+	/* Publish the item before the new head */
+	RB_MEMBARRIER();
+	RB_VHEAD(RingBuff) = head + 1;
 
 	return 1;
 }
@@ -82,16 +100,22 @@ int RingBuffer_Insert(RINGBUFF_T *RingBuff, const void *data)
 int RingBuffer_InsertMult(RINGBUFF_T *RingBuff, const void *data, int num)
 {
 	uint8_t *ptr = RingBuff->data;
-	int cnt1, cnt2;
+	uint32_t head = RingBuff->head;
+	int cnt1, cnt2, idx;
+
+	/* Calculate the segment lengths */
+	cnt1 = cnt2 = RingBuff->count - (int) (head - RB_VTAIL(RingBuff));
 
 	/* We cannot insert when queue is full */
-	if (RingBuffer_IsFull(RingBuff))
+	if (cnt1 <= 0)
 		return 0;
 
-	/* Calculate the segment lengths */
-	cnt1 = cnt2 = RingBuffer_GetFree(RingBuff);
-	if (RB_INDH(RingBuff) + cnt1 >= RingBuff->count)
-		cnt1 = RingBuff->count - RB_INDH(RingBuff);
+	/* Slots must not be written before the consumer released them */
+	RB_MEMBARRIER();
+
+	idx = head & (RingBuff->count - 1);
+	if (idx + cnt1 >= RingBuff->count)
+		cnt1 = RingBuff->count - idx;
 	cnt2 -= cnt1;
 
 	cnt1 = MIN(cnt1, num);
@@ -101,15 +125,17 @@ int RingBuffer_InsertMult(RINGBUFF_T *RingBuff, const void *data, int num)
 	num -= cnt2;
 
 	/* Write segment 1 */
-	ptr += RB_INDH(RingBuff) * RingBuff->itemSz;
+	ptr += idx * RingBuff->itemSz;
 	memcpy(ptr, data, cnt1 * RingBuff->itemSz);
-	RingBuff->head += cnt1;
 
 	/* Write segment 2 */
-	ptr = (uint8_t *) RingBuff->data + RB_INDH(RingBuff) * RingBuff->itemSz;
+	ptr = (uint8_t *) RingBuff->data;
 	data = (const uint8_t *) data + cnt1 * RingBuff->itemSz;
 	memcpy(ptr, data, cnt2 * RingBuff->itemSz);
-	RingBuff->head += cnt2;
+
+	/* Publish both segments with a single head update */
+	RB_MEMBARRIER();
+	RB_VHEAD(RingBuff) = head + cnt1 + cnt2;
 
 	return cnt1 + cnt2;
 }
@@ -118,14 +144,21 @@ int RingBuffer_InsertMult(RINGBUFF_T *RingBuff, const void *data, int num)
 int RingBuffer_Pop(RINGBUFF_T *RingBuff, void *data)
 {
 	uint8_t *ptr = RingBuff->data;
+	uint32_t tail = RingBuff->tail;
 
 	/* We cannot pop when queue is empty */
-	if (RingBuffer_IsEmpty(RingBuff))
+	if (RB_VHEAD(RingBuff) == tail)
 		return 0;
 
-	ptr += RB_INDT(RingBuff) * RingBuff->itemSz;
+	/* Item must not be read before the head that published it */
+	RB_MEMBARRIER();
+
+	ptr += (tail & (RingBuff->count - 1)) * RingBuff->itemSz;
 	memcpy(data, ptr, RingBuff->itemSz);
-	RingBuff->tail++;
+
+	/* Finish reading the item before handing the slot back */
+	RB_MEMBARRIER();
+	RB_VTAIL(RingBuff) = tail + 1;
 
 	return 1;
 }
@@ -134,16 +167,22 @@ int RingBuffer_Pop(RINGBUFF_T *RingBuff, void *data)
 int RingBuffer_PopMult(RINGBUFF_T *RingBuff, void *data, int num)
 {
 	uint8_t *ptr = RingBuff->data;
-	int cnt1, cnt2;
+	uint32_t tail = RingBuff->tail;
+	int cnt1, cnt2, idx;
 
-	/* We cannot insert when queue is empty */
-	if (RingBuffer_IsEmpty(RingBuff))
+	/* Calculate the segment lengths */
+	cnt1 = cnt2 = (int) (RB_VHEAD(RingBuff) - tail);
+
+	/* We cannot pop when queue is empty */
+	if (cnt1 <= 0)
 		return 0;
 
-	/* Calculate the segment lengths */
-	cnt1 = cnt2 = RingBuffer_GetCount(RingBuff);
-	if (RB_INDT(RingBuff) + cnt1 >= RingBuff->count)
-		cnt1 = RingBuff->count - RB_INDT(RingBuff);
+	/* Items must not be read before the head that published them */
+	RB_MEMBARRIER();
+
+	idx = tail & (RingBuff->count - 1);
+	if (idx + cnt1 >= RingBuff->count)
+		cnt1 = RingBuff->count - idx;
 	cnt2 -= cnt1;
 
 	cnt1 = MIN(cnt1, num);
@@ -152,16 +191,74 @@ int RingBuffer_PopMult(RINGBUFF_T *RingBuff, void *data, int num)
 	cnt2 = MIN(cnt2, num);
 	num -= cnt2;
 
-	/* Write segment 1 */
-	ptr += RB_INDT(RingBuff) * RingBuff->itemSz;
+	/* Read segment 1 */
+	ptr += idx * RingBuff->itemSz;
 	memcpy(data, ptr, cnt1 * RingBuff->itemSz);
-	RingBuff->tail += cnt1;
 
-	/* Write segment 2 */
-	ptr = (uint8_t *) RingBuff->data + RB_INDT(RingBuff) * RingBuff->itemSz;
+	/* Read segment 2 */
+	ptr = (uint8_t *) RingBuff->data;
 	data = (uint8_t *) data + cnt1 * RingBuff->itemSz;
 	memcpy(data, ptr, cnt2 * RingBuff->itemSz);
-	RingBuff->tail += cnt2;
+
+	/* Finish reading both segments before handing the slots back */
+	RB_MEMBARRIER();
+	RB_VTAIL(RingBuff) = tail + cnt1 + cnt2;
 
 	return cnt1 + cnt2;
 }
+
+/* Get free spans for in-place writing */
+int RingBuffer_ReserveWrite(RINGBUFF_T *RingBuff, RINGBUFF_SPAN_T span[2])
+{
+	uint32_t head = RingBuff->head;
+	int num = RingBuff->count - (int) (head - RB_VTAIL(RingBuff));
+
+	/* Slots must not be written before the consumer released them */
+	RB_MEMBARRIER();
+
+	return getSpans(RingBuff, head, num, span);
+}
+
+/* Commit items written in place */
+int RingBuffer_CommitWrite(RINGBUFF_T *RingBuff, int num)
+{
+	uint32_t head = RingBuff->head;
+
+	num = MIN(num, RingBuff->count - (int) (head - RB_VTAIL(RingBuff)));
+	if (num <= 0)
+		return 0;
+
+	/* Publish the items before the new head */
+	RB_MEMBARRIER();
+	RB_VHEAD(RingBuff) = head + num;
+
+	return num;
+}
+
+/* Get pending spans for in-place reading */
+int RingBuffer_PeekRead(RINGBUFF_T *RingBuff, RINGBUFF_SPAN_T span[2])
+{
+	uint32_t tail = RingBuff->tail;
+	int num = (int) (RB_VHEAD(RingBuff) - tail);
+
+	/* Items must not be read before the head that published them */
+	RB_MEMBARRIER();
+
+	return getSpans(RingBuff, tail, num, span);
+}
+
+/* Release items read in place */
+int RingBuffer_ConsumeRead(RINGBUFF_T *RingBuff, int num)
+{
+	uint32_t tail = RingBuff->tail;
+
+	num = MIN(num, (int) (RB_VHEAD(RingBuff) - tail));
+	if (num <= 0)
+		return 0;
+
+	/* Finish reading the items before handing the slots back */
+	RB_MEMBARRIER();
+	RB_VTAIL(RingBuff) = tail + num;
+
+	return num;
+}
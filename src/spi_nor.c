@@ -0,0 +1,443 @@
+/*
+ * @brief SPI NOR flash driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2012
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+#include "spi_nor.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Largest device reachable with 3 byte addresses */
+#define SPINOR_MAX_SIZE         (1UL << 24)
+
+/* SFDP signature "SFDP", little endian */
+#define SFDP_SIGNATURE          0x50444653
+
+/* SFDP basic flash parameter table ID and the number of DWORDs used */
+#define SFDP_BFPT_ID            0xFF00
+#define SFDP_BFPT_DWORDS        11
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Run a command with the chip select held: cmdLen header bytes, then len
+   data bytes sent from tx or received into rx */
+STATIC Status SpiNor_Command(SPINOR_T *flash, const uint8_t *cmd, uint32_t cmdLen,
+							 const uint8_t *tx, uint8_t *rx, uint32_t len)
+{
+	const SPINOR_BUS_T *bus = flash->bus;
+	Status ret;
+
+	bus->select(flash->busData, true);
+	ret = bus->transfer(flash->busData, cmd, NULL, cmdLen);
+	if ((ret == SUCCESS) && (len != 0)) {
+		ret = bus->transfer(flash->busData, tx, rx, len);
+	}
+	bus->select(flash->busData, false);
+
+	return ret;
+}
+
+/* Build an opcode with a 3 byte address and a dummy byte, returns the
+   header length without the dummy byte */
+STATIC uint32_t SpiNor_SetAddr(uint8_t *cmd, uint8_t opcode, uint32_t addr)
+{
+	cmd[0] = opcode;
+	cmd[1] = (uint8_t) (addr >> 16);
+	cmd[2] = (uint8_t) (addr >> 8);
+	cmd[3] = (uint8_t) addr;
+	cmd[4] = 0xFF;
+
+	return 4;
+}
+
+/* Returns true if the area is inside the device */
+STATIC bool SpiNor_InRange(SPINOR_T *flash, uint32_t addr, uint32_t len)
+{
+	return (addr <= flash->size) && (len <= (flash->size - addr));
+}
+
+/* Send a write enable */
+STATIC Status SpiNor_WriteEnable(SPINOR_T *flash)
+{
+	uint8_t cmd = SPINOR_CMD_WREN;
+
+	return SpiNor_Command(flash, &cmd, 1, NULL, NULL, 0);
+}
+
+/* Start programming of a page, the device is busy on return */
+STATIC Status SpiNor_ProgramPage(SPINOR_T *flash, uint32_t addr, const uint8_t *data, uint32_t len)
+{
+	uint8_t cmd[5];
+
+	if (SpiNor_WriteEnable(flash) != SUCCESS) {
+		return ERROR;
+	}
+
+	return SpiNor_Command(flash, cmd, SpiNor_SetAddr(cmd, SPINOR_CMD_PP, addr), data, NULL, len);
+}
+
+/* Bytes to program at addr without crossing a page boundary */
+STATIC uint32_t SpiNor_PageChunk(SPINOR_T *flash, uint32_t addr, uint32_t len)
+{
+	return MIN(flash->pageSize - (addr & (flash->pageSize - 1)), len);
+}
+
+/* Read from the SFDP area */
+STATIC Status SpiNor_ReadSFDP(SPINOR_T *flash, uint32_t addr, uint8_t *buf, uint32_t len)
+{
+	uint8_t cmd[5];
+
+	SpiNor_SetAddr(cmd, SPINOR_CMD_SFDP, addr);
+	return SpiNor_Command(flash, cmd, 5, NULL, buf, len);
+}
+
+/* Little endian DWORD from SFDP data */
+STATIC uint32_t SpiNor_GetDword(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+/* Add an erase type, keeping the list sorted largest first */
+STATIC void SpiNor_AddErase(SPINOR_T *flash, uint8_t opcode, uint8_t shift)
+{
+	int i = SPINOR_ERASE_TYPES - 1;
+
+	if ((shift == 0) || (shift > 24) || (flash->erase[i].shift != 0)) {
+		return;
+	}
+	while ((i > 0) && (flash->erase[i - 1].shift < shift)) {
+		flash->erase[i] = flash->erase[i - 1];
+		i--;
+	}
+	flash->erase[i].opcode = opcode;
+	flash->erase[i].shift = shift;
+}
+
+/* Read the geometry from the SFDP basic flash parameter table, returns
+   ERROR and leaves the device structure alone if there is none */
+STATIC Status SpiNor_ParseSFDP(SPINOR_T *flash)
+{
+	uint8_t buf[SFDP_BFPT_DWORDS * 4];
+	uint32_t dw[SFDP_BFPT_DWORDS];
+	uint32_t ptr = 0, len = 0, i, n;
+
+	/* Header, then the parameter headers for the first basic table */
+	if ((SpiNor_ReadSFDP(flash, 0, buf, 8) != SUCCESS) ||
+		(SpiNor_GetDword(buf) != SFDP_SIGNATURE)) {
+		return ERROR;
+	}
+	n = buf[6] + 1;
+	for (i = 0; i < n; i++) {
+		if (SpiNor_ReadSFDP(flash, 8 + (i * 8), buf, 8) != SUCCESS) {
+			return ERROR;
+		}
+		if ((buf[0] | (buf[7] << 8)) == SFDP_BFPT_ID) {
+			len = buf[3];
+			ptr = buf[4] | (buf[5] << 8) | (buf[6] << 16);
+			break;
+		}
+	}
+	if (len < 9) {
+		return ERROR;
+	}
+
+	len = MIN(len, SFDP_BFPT_DWORDS);
+	if (SpiNor_ReadSFDP(flash, ptr, buf, len * 4) != SUCCESS) {
+		return ERROR;
+	}
+	for (i = 0; i < len; i++) {
+		dw[i] = SpiNor_GetDword(&buf[i * 4]);
+	}
+
+	/* DWORD 2 is the density in bits, either N - 1 or 2^N */
+	if (dw[1] & (1UL << 31)) {
+		n = dw[1] & 0x7FFFFFFF;
+		flash->size = (n < 3) ? 0 : ((n - 3) >= 24) ? SPINOR_MAX_SIZE : (1UL << (n - 3));
+	}
+	else {
+		flash->size = MIN((dw[1] >> 3) + 1, SPINOR_MAX_SIZE);
+	}
+	/* Devices only taking 4 byte addresses are not supported */
+	if (((dw[0] >> 17) & 0x3) == 2) {
+		flash->size = 0;
+	}
+
+	/* Erase types 1 to 4 in DWORDs 8 and 9, 4 KB erase in DWORD 1 */
+	memset(flash->erase, 0, sizeof(flash->erase));
+	for (i = 0; i < SPINOR_ERASE_TYPES; i++) {
+		n = dw[7 + (i / 2)] >> ((i & 1) * 16);
+		SpiNor_AddErase(flash, (uint8_t) (n >> 8), (uint8_t) n);
+	}
+	if ((flash->erase[0].shift == 0) && ((dw[0] & 0x3) == 1)) {
+		SpiNor_AddErase(flash, (uint8_t) (dw[0] >> 8), 12);
+	}
+
+	/* DWORD 11 (JESD216A) has the page size */
+	flash->pageSize = 256;
+	if (len >= 11) {
+		flash->pageSize = 1UL << ((dw[10] >> 4) & 0xF);
+	}
+	flash->sfdp = true;
+
+	return SUCCESS;
+}
+
+#if defined(CORE_M0)
+/* SSP binding chip select */
+STATIC void SpiNor_SSPSelect(void *bus, bool assert)
+{
+	SPINOR_SSP_T *ssp = (SPINOR_SSP_T *) bus;
+
+	Chip_GPIO_SetPinState(LPC_GPIO, ssp->cs.port, ssp->cs.pin, !assert);
+}
+
+/* SSP binding transfer */
+STATIC Status SpiNor_SSPTransfer(void *bus, const uint8_t *tx, uint8_t *rx, uint32_t len)
+{
+	SPINOR_SSP_T *ssp = (SPINOR_SSP_T *) bus;
+	Chip_SSP_DATA_SETUP_T xf;
+
+	xf.tx_data = (void *) tx;
+	xf.rx_data = rx;
+	xf.tx_cnt = 0;
+	xf.rx_cnt = 0;
+	xf.length = len;
+	Chip_SSP_RWFrames_Blocking(ssp->pSSP, &xf);
+
+	return (xf.rx_cnt == len) ? SUCCESS : ERROR;
+}
+
+static const SPINOR_BUS_T spiNorSSPBus = {
+	SpiNor_SSPSelect,
+	SpiNor_SSPTransfer,
+};
+#endif
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Detect a SPI NOR device */
+Status SpiNor_Init(SPINOR_T *flash, const SPINOR_BUS_T *bus, void *busData)
+{
+	uint8_t cmd = SPINOR_CMD_RDID;
+	uint8_t id[3];
+
+	memset(flash, 0, sizeof(*flash));
+	flash->bus = bus;
+	flash->busData = busData;
+
+	if (SpiNor_Command(flash, &cmd, 1, NULL, id, 3) != SUCCESS) {
+		return ERROR;
+	}
+	flash->jedecId = (id[0] << 16) | (id[1] << 8) | id[2];
+	if ((flash->jedecId == 0) || (flash->jedecId == 0xFFFFFF)) {
+		return ERROR;
+	}
+
+	if (SpiNor_ParseSFDP(flash) != SUCCESS) {
+		/* Most vendors encode the size as 2^N bytes in the capacity byte */
+		if ((id[2] >= 16) && (id[2] < 32)) {
+			flash->size = MIN(1UL << id[2], SPINOR_MAX_SIZE);
+		}
+		flash->pageSize = 256;
+		SpiNor_AddErase(flash, SPINOR_CMD_BE, 16);
+		SpiNor_AddErase(flash, SPINOR_CMD_SE, 12);
+	}
+
+	return ((flash->size != 0) && (SpiNor_GetEraseSize(flash) != 0)) ? SUCCESS : ERROR;
+}
+
+/* Read from the device */
+Status SpiNor_Read(SPINOR_T *flash, uint32_t addr, void *buf, uint32_t len)
+{
+	uint8_t cmd[5];
+
+	if (!SpiNor_InRange(flash, addr, len)) {
+		return ERROR;
+	}
+	if (len == 0) {
+		return SUCCESS;
+	}
+
+	SpiNor_SetAddr(cmd, SPINOR_CMD_FAST_READ, addr);
+	return SpiNor_Command(flash, cmd, 5, NULL, (uint8_t *) buf, len);
+}
+
+/* Program the device from a buffer */
+Status SpiNor_Program(SPINOR_T *flash, uint32_t addr, const void *data, uint32_t len)
+{
+	const uint8_t *p = (const uint8_t *) data;
+	uint32_t n;
+
+	if (!SpiNor_InRange(flash, addr, len)) {
+		return ERROR;
+	}
+
+	while (len) {
+		n = SpiNor_PageChunk(flash, addr, len);
+		if ((SpiNor_ProgramPage(flash, addr, p, n) != SUCCESS) ||
+			(SpiNor_WaitReady(flash) != SUCCESS)) {
+			return ERROR;
+		}
+		addr += n;
+		p += n;
+		len -= n;
+	}
+
+	return SUCCESS;
+}
+
+/* Program the device from a data source */
+Status SpiNor_ProgramFill(SPINOR_T *flash, uint32_t addr, uint32_t len,
+						  SPINOR_FILL_T fill, void *arg, uint8_t *pageBuf)
+{
+	uint32_t offset = 0, n;
+
+	if (!SpiNor_InRange(flash, addr, len)) {
+		return ERROR;
+	}
+	if (len == 0) {
+		return SUCCESS;
+	}
+
+	n = SpiNor_PageChunk(flash, addr, len);
+	fill(arg, pageBuf, 0, n);
+	while (1) {
+		if (SpiNor_ProgramPage(flash, addr, pageBuf, n) != SUCCESS) {
+			return ERROR;
+		}
+		addr += n;
+		offset += n;
+		len -= n;
+
+		/* The page has been sent, prepare the next one while it programs */
+		if (len) {
+			n = SpiNor_PageChunk(flash, addr, len);
+			fill(arg, pageBuf, offset, n);
+		}
+		if (SpiNor_WaitReady(flash) != SUCCESS) {
+			return ERROR;
+		}
+		if (len == 0) {
+			return SUCCESS;
+		}
+	}
+}
+
+/* Erase an area of the device */
+Status SpiNor_Erase(SPINOR_T *flash, uint32_t addr, uint32_t len)
+{
+	uint32_t min = SpiNor_GetEraseSize(flash);
+	uint32_t size = 0;
+	uint8_t cmd[5];
+	int i;
+
+	if ((min == 0) || ((addr | len) & (min - 1)) || !SpiNor_InRange(flash, addr, len)) {
+		return ERROR;
+	}
+
+	while (len) {
+		for (i = 0; i < SPINOR_ERASE_TYPES; i++) {
+			size = 1UL << flash->erase[i].shift;
+			if ((flash->erase[i].shift != 0) && !(addr & (size - 1)) && (size <= len)) {
+				break;
+			}
+		}
+		if ((SpiNor_WriteEnable(flash) != SUCCESS) ||
+			(SpiNor_Command(flash, cmd, SpiNor_SetAddr(cmd, flash->erase[i].opcode, addr),
+							NULL, NULL, 0) != SUCCESS) ||
+			(SpiNor_WaitReady(flash) != SUCCESS)) {
+			return ERROR;
+		}
+		addr += size;
+		len -= size;
+	}
+
+	return SUCCESS;
+}
+
+/* Get the smallest erase size */
+uint32_t SpiNor_GetEraseSize(SPINOR_T *flash)
+{
+	int i;
+
+	for (i = SPINOR_ERASE_TYPES - 1; i >= 0; i--) {
+		if (flash->erase[i].shift != 0) {
+			return 1UL << flash->erase[i].shift;
+		}
+	}
+
+	return 0;
+}
+
+/* Wait until a program or erase is done */
+Status SpiNor_WaitReady(SPINOR_T *flash)
+{
+	const SPINOR_BUS_T *bus = flash->bus;
+	uint8_t cmd = SPINOR_CMD_RDSR;
+	uint8_t status = SPINOR_SR_WIP;
+	uint32_t polls = SPINOR_POLL_MAX;
+	Status ret;
+
+	/* The status register is sent continuously while the chip select is held */
+	bus->select(flash->busData, true);
+	ret = bus->transfer(flash->busData, &cmd, NULL, 1);
+	while ((ret == SUCCESS) && (status & SPINOR_SR_WIP)) {
+		if (polls-- == 0) {
+			ret = ERROR;
+		}
+		else {
+			ret = bus->transfer(flash->busData, NULL, &status, 1);
+		}
+	}
+	bus->select(flash->busData, false);
+
+	return ret;
+}
+
+#if defined(CORE_M0)
+/* Detect a SPI NOR device on an SSP */
+Status SpiNor_InitSSP(SPINOR_T *flash, SPINOR_SSP_T *ssp)
+{
+	Chip_GPIO_SetPinState(LPC_GPIO, ssp->cs.port, ssp->cs.pin, true);
+	Chip_GPIO_SetPinDIROutput(LPC_GPIO, ssp->cs.port, ssp->cs.pin);
+
+	return SpiNor_Init(flash, &spiNorSSPBus, ssp);
+}
+#endif
@@ -35,6 +35,29 @@
  * Private types/enumerations/variables
  ****************************************************************************/
 
+/* Interrupts used by the job queue */
+#define SSP_JOB_INTS (SSP_RORIM | SSP_RTIM | SSP_RXIM)
+
+/* Queued jobs, head is the active job */
+static SSP_JOB_T *sspJob;
+static SSP_JOB_T *sspJobTail;
+
+/* DMA transfer state */
+typedef struct {
+	SSP_DMA_CALLBACK_T callback;	/* Completion callback */
+	const uint8_t *txData;			/* Next frames to send, NULL for dummy frames */
+	uint8_t *rxData;				/* Memory for the next frames, NULL to drop them */
+	uint32_t framesLeft;			/* Frames not yet handed to the DMA */
+	uint32_t frameSize;				/* 1 or 2 bytes per frame */
+	volatile bool busy;				/* Chip_SSP_TransferDMA() in progress */
+} SSP_DMA_STATE_T;
+
+static SSP_DMA_STATE_T sspDMA;
+
+/* Constant source of the dummy frames and sink of the dropped frames */
+static const uint16_t sspDMADummy = 0xFFFF;
+static uint16_t sspDMASink;
+
 /*****************************************************************************
  * Public types/enumerations/variables
  ****************************************************************************/
@@ -121,17 +144,8 @@ STATIC CHIP_SYSCTL_CLOCK_T Chip_SSP_GetClockIndex(LPC_SSP_T *pSSP)
 /* Returns reset ID for the peripheral block */
 STATIC CHIP_SYSCTL_PERIPH_RESET_T Chip_SSP_GetResetIndex(LPC_SSP_T *pSSP)
 {
-	CHIP_SYSCTL_PERIPH_RESET_T resetSSP;
-
-	/*
-	if (pSSP == LPC_SSP0) {
-		resetSSP = RESET_SSP0;
-	}
-	else {
-		resetSSP = RESET_SSP1;
-	}
-	*/
-
+	/* The LPC122x has a single SSP */
+	(void) pSSP;
 	return RESET_SSP0;
 }
 
@@ -165,206 +179,386 @@ STATIC uint32_t Chip_SSP_GetPCLKkRate(LPC_SSP_T *pSSP)
     return sspCLK;
 }
 
-/*****************************************************************************
- * Public functions
- ****************************************************************************/
-
-/*Set up output clocks per bit for SSP bus*/
-void Chip_SSP_SetClockRate(LPC_SSP_T *pSSP, uint32_t clk_rate, uint32_t prescale)
+/* Find the dividers giving the highest bit rate not above bitRate, with a
+   clock divider of at most maxClkDiv. The bit rate is
+   clkin / (clkDiv * CPSR * (SCR + 1)), with CPSR = 2 * k. For each SCR + 1
+   the smallest clkDiv * k product is taken directly when it fits clkDiv
+   alone, the largest clkDiv then also gives the lowest SSP clock. */
+STATIC Status SSP_SolveDividers(uint32_t clkin, uint32_t bitRate, uint32_t maxClkDiv, SSP_CLOCK_T *pClk)
 {
-	uint32_t temp;
-	temp = pSSP->CR0 & (~(SSP_CR0_SCR(0xFF)));
-	pSSP->CR0 = temp | (SSP_CR0_SCR(clk_rate));
-	pSSP->CPSR = prescale;
-}
+	uint32_t minDiv, minProd, best = 0xFFFFFFFF, bestDiv = 0;
+	uint32_t scr1, prod, div, k, kk, cand;
 
-/* SSP Polling Read/Write in blocking mode */
-uint32_t Chip_SSP_RWFrames_Blocking(LPC_SSP_T *pSSP, Chip_SSP_DATA_SETUP_T *xf_setup)
-{
-	/* Clear all remaining frames in RX FIFO */
-	while (Chip_SSP_GetStatus(pSSP, SSP_STAT_RNE)) {
-		Chip_SSP_ReceiveFrame(pSSP);
+	if ((clkin == 0) || (bitRate == 0) || (maxClkDiv == 0)) {
+		return ERROR;
 	}
 
-	/* Clear status */
-	Chip_SSP_ClearIntPending(pSSP, SSP_INT_CLEAR_BITMASK);
-
-	if (Chip_SSP_GetDataSize(pSSP) > SSP_BITS_8) {
-		while (xf_setup->rx_cnt < xf_setup->length || xf_setup->tx_cnt < xf_setup->length) {
-			/* write data to buffer */
-			if (( Chip_SSP_GetStatus(pSSP, SSP_STAT_TNF) == SET) && ( xf_setup->tx_cnt < xf_setup->length) ) {
-				SSP_Write2BFifo(pSSP, xf_setup);
-			}
+	/* Smallest clkDiv * k * (SCR + 1) product for the total divider */
+	minDiv = (clkin + bitRate - 1) / bitRate;
+	minProd = (minDiv + 1) / 2;
 
-			/* Check overrun error */
-			if (Chip_SSP_GetRawIntStatus(pSSP, SSP_RORRIS) == SET) {
-				return ERROR;
-			}
+	for (scr1 = 1; scr1 <= 256; scr1++) {
+		prod = (minProd + scr1 - 1) / scr1;
+		if ((prod * scr1) > best) {
+			continue;
+		}
 
-			/* Check for any data available in RX FIFO */
-			SSP_Read2BFifo(pSSP, xf_setup);
+		if (prod <= maxClkDiv) {
+			div = prod;
+			k = 1;
 		}
-	}
-	else {
-		while (xf_setup->rx_cnt < xf_setup->length || xf_setup->tx_cnt < xf_setup->length) {
-			/* write data to buffer */
-			if (( Chip_SSP_GetStatus(pSSP, SSP_STAT_TNF) == SET) && ( xf_setup->tx_cnt < xf_setup->length) ) {
-				SSP_Write1BFifo(pSSP, xf_setup);
+		else {
+			/* Smallest product clkDiv * k not below prod */
+			kk = (prod + maxClkDiv - 1) / maxClkDiv;
+			if (kk > 127) {
+				continue;
 			}
-
-			/* Check overrun error */
-			if (Chip_SSP_GetRawIntStatus(pSSP, SSP_RORRIS) == SET) {
-				return ERROR;
+			cand = 0xFFFFFFFF;
+			k = kk;
+			for (; kk <= 127; kk++) {
+				div = kk * ((prod + kk - 1) / kk);
+				if (div < cand) {
+					cand = div;
+					k = kk;
+					if (div == prod) {
+						break;
+					}
+				}
 			}
+			prod = cand;
+			div = cand / k;
+		}
 
-			/* Check for any data available in RX FIFO */
-			SSP_Read1BFifo(pSSP, xf_setup);
+		if (((prod * scr1) < best) || (((prod * scr1) == best) && (div > bestDiv))) {
+			best = prod * scr1;
+			bestDiv = div;
+			pClk->clkDiv = (uint8_t) div;
+			pClk->cpsr = (uint8_t) (2 * k);
+			pClk->scr = (uint8_t) (scr1 - 1);
 		}
 	}
-	if (xf_setup->tx_data) {
-		return xf_setup->tx_cnt;
-	}
-	else if (xf_setup->rx_data) {
-		return xf_setup->rx_cnt;
+
+	if (bestDiv == 0) {
+		return ERROR;
 	}
+	pClk->bitRate = clkin / (2 * best);
 
-	return 0;
+	return SUCCESS;
 }
 
-/* SSP Polling Write in blocking mode */
-uint32_t Chip_SSP_WriteFrames_Blocking(LPC_SSP_T *pSSP, uint8_t *buffer, uint32_t buffer_len)
+/* Find the SCR and prescale values for a bit rate at the current SSP clock */
+STATIC void SSP_CalcClockRate(LPC_SSP_T *pSSP, uint32_t bitRate, uint32_t *pScr, uint32_t *pPrescale)
 {
-	uint32_t tx_cnt = 0, rx_cnt = 0;
+	SSP_CLOCK_T clk;
 
-	/* Clear all remaining frames in RX FIFO */
-	while (Chip_SSP_GetStatus(pSSP, SSP_STAT_RNE)) {
-		Chip_SSP_ReceiveFrame(pSSP);
+	if (SSP_SolveDividers(Chip_SSP_GetPCLKkRate(pSSP), bitRate, 1, &clk) != SUCCESS) {
+		/* Slowest rate */
+		clk.scr = 0xFF;
+		clk.cpsr = 254;
 	}
+	*pScr = clk.scr;
+	*pPrescale = clk.cpsr;
+}
 
-	/* Clear status */
-	Chip_SSP_ClearIntPending(pSSP, SSP_INT_CLEAR_BITMASK);
+/* Move frames of the active job, keeping at most a FIFO worth in flight */
+STATIC void SSP_JobPump(LPC_SSP_T *pSSP, SSP_JOB_T *job)
+{
+	Chip_SSP_DATA_SETUP_T *xf_setup = &job->xf;
 
 	if (Chip_SSP_GetDataSize(pSSP) > SSP_BITS_8) {
-		uint16_t *wdata16;
+		SSP_Read2BFifo(pSSP, xf_setup);
+		while ((Chip_SSP_GetStatus(pSSP, SSP_STAT_TNF) == SET) && (xf_setup->tx_cnt < xf_setup->length) &&
+			   ((xf_setup->tx_cnt - xf_setup->rx_cnt) < (SSP_FIFO_DEPTH * 2))) {
+			SSP_Write2BFifo(pSSP, xf_setup);
+		}
+	}
+	else {
+		SSP_Read1BFifo(pSSP, xf_setup);
+		while ((Chip_SSP_GetStatus(pSSP, SSP_STAT_TNF) == SET) && (xf_setup->tx_cnt < xf_setup->length) &&
+			   ((xf_setup->tx_cnt - xf_setup->rx_cnt) < SSP_FIFO_DEPTH)) {
+			SSP_Write1BFifo(pSSP, xf_setup);
+		}
+	}
+}
 
-		wdata16 = (uint16_t *) buffer;
+/* Set up the SSP for a job, assert its chip select and fill the FIFO */
+STATIC void SSP_JobStart(LPC_SSP_T *pSSP, SSP_JOB_T *job)
+{
+	pSSP->CR0 = job->cr0;
+	pSSP->CPSR = job->cpsr;
 
-		while (tx_cnt < buffer_len || rx_cnt < buffer_len) {
-			/* write data to buffer */
-			if ((Chip_SSP_GetStatus(pSSP, SSP_STAT_TNF) == SET) && (tx_cnt < buffer_len)) {
-				Chip_SSP_SendFrame(pSSP, *wdata16);
-				wdata16++;
-				tx_cnt += 2;
-			}
+	if (job->start) {
+		job->start(pSSP, job);
+	}
+	if (!(job->flags & SSP_JOB_NO_CS)) {
+		Chip_GPIO_SetPinState(LPC_GPIO, job->cs.port, job->cs.pin, false);
+	}
+	SSP_JobPump(pSSP, job);
+}
 
-			/* Check overrun error */
-			if (Chip_SSP_GetRawIntStatus(pSSP, SSP_RORRIS) == SET) {
-				return ERROR;
-			}
+/* End the active job and start the next one */
+STATIC void SSP_JobFinish(LPC_SSP_T *pSSP, SSP_JOB_STATUS_T status)
+{
+	SSP_JOB_T *job = sspJob;
 
-			/* Check for any data available in RX FIFO */
-			while (Chip_SSP_GetStatus(pSSP, SSP_STAT_RNE) == SET) {
-				Chip_SSP_ReceiveFrame(pSSP);	/* read dummy data */
-				rx_cnt += 2;
-			}
-		}
+	if (!(job->flags & (SSP_JOB_NO_CS | SSP_JOB_CS_HOLD)) || (status != SSP_JOB_DONE)) {
+		Chip_GPIO_SetPinState(LPC_GPIO, job->cs.port, job->cs.pin, true);
+	}
+
+	sspJob = job->next;
+	job->next = NULL;
+	job->status = status;
+	if (sspJob) {
+		SSP_JobStart(pSSP, sspJob);
 	}
 	else {
-		uint8_t *wdata8;
+		sspJobTail = NULL;
+		pSSP->IMSC &= ~SSP_JOB_INTS;
+	}
 
-		wdata8 = buffer;
+	if (job->callback) {
+		job->callback(pSSP, job);
+	}
+}
 
-		while (tx_cnt < buffer_len || rx_cnt < buffer_len) {
-			/* write data to buffer */
-			if ((Chip_SSP_GetStatus(pSSP, SSP_STAT_TNF) == SET) && (tx_cnt < buffer_len)) {
-				Chip_SSP_SendFrame(pSSP, *wdata8);
-				wdata8++;
-				tx_cnt++;
-			}
+/* Hand the next chunk of a DMA transfer to both channels, receive first */
+STATIC void SSP_DMASendChunk(LPC_SSP_T *pSSP)
+{
+	uint32_t cnt = MIN(sspDMA.framesLeft, DMA_MAX_XFER);
+	uint32_t size = (sspDMA.frameSize == 2) ? (DMA_CTRL_SRC_SIZE_16 | DMA_CTRL_DST_SIZE_16) :
+					(DMA_CTRL_SRC_SIZE_8 | DMA_CTRL_DST_SIZE_8);
+	uint32_t inc = (sspDMA.frameSize == 2) ? DMA_CTRL_DST_INC_16 : DMA_CTRL_DST_INC_8;
 
-			/* Check overrun error */
-			if (Chip_SSP_GetRawIntStatus(pSSP, SSP_RORRIS) == SET) {
-				return ERROR;
-			}
+	if (sspDMA.rxData) {
+		Chip_DMA_Transfer(LPC_DMA, DMA_CH_SSP0_RX, DMA_CTRL_CYCLE_BASIC | size | DMA_CTRL_SRC_INC_NONE | inc,
+						  &pSSP->DR, sspDMA.rxData, cnt);
+		sspDMA.rxData += cnt * sspDMA.frameSize;
+	}
+	else {
+		Chip_DMA_Transfer(LPC_DMA, DMA_CH_SSP0_RX,
+						  DMA_CTRL_CYCLE_BASIC | size | DMA_CTRL_SRC_INC_NONE | DMA_CTRL_DST_INC_NONE,
+						  &pSSP->DR, &sspDMASink, cnt);
+	}
 
-			/* Check for any data available in RX FIFO */
-			while (Chip_SSP_GetStatus(pSSP, SSP_STAT_RNE) == SET && rx_cnt < buffer_len) {
-				Chip_SSP_ReceiveFrame(pSSP);	/* read dummy data */
-				rx_cnt++;
-			}
-		}
+	/* Source increment is the destination increment moved down four bits */
+	if (sspDMA.txData) {
+		Chip_DMA_Transfer(LPC_DMA, DMA_CH_SSP0_TX, DMA_CTRL_CYCLE_BASIC | size | (inc >> 4) | DMA_CTRL_DST_INC_NONE,
+						  sspDMA.txData, &pSSP->DR, cnt);
+		sspDMA.txData += cnt * sspDMA.frameSize;
+	}
+	else {
+		Chip_DMA_Transfer(LPC_DMA, DMA_CH_SSP0_TX,
+						  DMA_CTRL_CYCLE_BASIC | size | DMA_CTRL_SRC_INC_NONE | DMA_CTRL_DST_INC_NONE,
+						  &sspDMADummy, &pSSP->DR, cnt);
 	}
 
-	return tx_cnt;
+	sspDMA.framesLeft -= cnt;
+}
 
+/* End a DMA transfer */
+STATIC void SSP_DMAFinish(LPC_SSP_T *pSSP, SSP_DMA_EVENT_T event)
+{
+	pSSP->DMACR = 0;
+	sspDMA.framesLeft = 0;
+	sspDMA.busy = false;
+	if (sspDMA.callback) {
+		sspDMA.callback(pSSP, event);
+	}
 }
 
-/* SSP Polling Read in blocking mode */
-uint32_t Chip_SSP_ReadFrames_Blocking(LPC_SSP_T *pSSP, uint8_t *buffer, uint32_t buffer_len)
+/* Receive DMA channel callback, the receive side completes last */
+STATIC void SSP_DMARxCallback(DMA_CHID_T ch, DMA_EVENT_T event)
 {
-	uint32_t rx_cnt = 0, tx_cnt = 0;
+	(void) ch;
+	if (event == DMA_EVENT_ERROR) {
+		Chip_DMA_Abort(LPC_DMA, DMA_CH_SSP0_TX);
+		SSP_DMAFinish(LPC_SSP0, SSP_DMA_EVENT_ERROR);
+	}
+	else if (sspDMA.framesLeft > 0) {
+		SSP_DMASendChunk(LPC_SSP0);
+	}
+	else {
+		SSP_DMAFinish(LPC_SSP0, SSP_DMA_EVENT_DONE);
+	}
+}
 
-	/* Clear all remaining frames in RX FIFO */
-	while (Chip_SSP_GetStatus(pSSP, SSP_STAT_RNE)) {
-		Chip_SSP_ReceiveFrame(pSSP);
+/* Transmit DMA channel callback, only errors are of interest */
+STATIC void SSP_DMATxCallback(DMA_CHID_T ch, DMA_EVENT_T event)
+{
+	(void) ch;
+	if (event == DMA_EVENT_ERROR) {
+		Chip_DMA_Abort(LPC_DMA, DMA_CH_SSP0_RX);
+		SSP_DMAFinish(LPC_SSP0, SSP_DMA_EVENT_ERROR);
 	}
+}
 
-	/* Clear status */
+/* Empty the RX FIFO and clear the interrupt status before a blocking transfer */
+STATIC void SSP_BlockingStart(LPC_SSP_T *pSSP)
+{
+	while (pSSP->SR & SSP_STAT_RNE) {
+		(void) pSSP->DR;
+	}
 	Chip_SSP_ClearIntPending(pSSP, SSP_INT_CLEAR_BITMASK);
+}
 
-	if (Chip_SSP_GetDataSize(pSSP) > SSP_BITS_8) {
-		uint16_t *rdata16;
+/* Blocking transfer of frames up to 8 bits. Up to a FIFO worth of frames
+   is kept in flight, which also bounds the RX FIFO level. A NULL buffer
+   becomes a fixed dummy source or sink, so the loops have no per-frame
+   checks. Returns the number of frames received, less on RX overrun. */
+STATIC uint32_t SSP_Blocking8(LPC_SSP_T *pSSP, const uint8_t *tx, uint8_t *rx, uint32_t frames)
+{
+	const uint8_t txDummy = 0xFF;
+	uint8_t rxSink;
+	uint32_t txInc = 1, rxInc = 1;
+	uint32_t txLeft = frames, rxLeft = frames;
 
-		rdata16 = (uint16_t *) buffer;
+	if (!tx) {
+		tx = &txDummy;
+		txInc = 0;
+	}
+	if (!rx) {
+		rx = &rxSink;
+		rxInc = 0;
+	}
 
-		while (tx_cnt < buffer_len || rx_cnt < buffer_len) {
-			/* write data to buffer */
-			if ((Chip_SSP_GetStatus(pSSP, SSP_STAT_TNF) == SET) && (tx_cnt < buffer_len)) {
-				Chip_SSP_SendFrame(pSSP, 0xFFFF);	/* just send dummy data */
-				tx_cnt += 2;
-			}
+	while (rxLeft) {
+		while (txLeft && ((rxLeft - txLeft) < SSP_FIFO_DEPTH)) {
+			pSSP->DR = *tx;
+			tx += txInc;
+			txLeft--;
+		}
+		while (pSSP->SR & SSP_STAT_RNE) {
+			*rx = (uint8_t) pSSP->DR;
+			rx += rxInc;
+			rxLeft--;
+		}
+		if (pSSP->RIS & SSP_RORRIS) {
+			break;
+		}
+	}
 
-			/* Check overrun error */
-			if (Chip_SSP_GetRawIntStatus(pSSP, SSP_RORRIS) == SET) {
-				return ERROR;
-			}
+	return frames - rxLeft;
+}
 
-			/* Check for any data available in RX FIFO */
-			while (Chip_SSP_GetStatus(pSSP, SSP_STAT_RNE) == SET && rx_cnt < buffer_len) {
-				*rdata16 = Chip_SSP_ReceiveFrame(pSSP);
-				rdata16++;
-				rx_cnt += 2;
-			}
+/* Blocking transfer of frames over 8 bits, see SSP_Blocking8() */
+STATIC uint32_t SSP_Blocking16(LPC_SSP_T *pSSP, const uint16_t *tx, uint16_t *rx, uint32_t frames)
+{
+	const uint16_t txDummy = 0xFFFF;
+	uint16_t rxSink;
+	uint32_t txInc = 1, rxInc = 1;
+	uint32_t txLeft = frames, rxLeft = frames;
+
+	if (!tx) {
+		tx = &txDummy;
+		txInc = 0;
+	}
+	if (!rx) {
+		rx = &rxSink;
+		rxInc = 0;
+	}
+
+	while (rxLeft) {
+		while (txLeft && ((rxLeft - txLeft) < SSP_FIFO_DEPTH)) {
+			pSSP->DR = *tx;
+			tx += txInc;
+			txLeft--;
+		}
+		while (pSSP->SR & SSP_STAT_RNE) {
+			*rx = (uint16_t) pSSP->DR;
+			rx += rxInc;
+			rxLeft--;
+		}
+		if (pSSP->RIS & SSP_RORRIS) {
+			break;
 		}
 	}
+
+	return frames - rxLeft;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/*Set up output clocks per bit for SSP bus*/
+void Chip_SSP_SetClockRate(LPC_SSP_T *pSSP, uint32_t clk_rate, uint32_t prescale)
+{
+	uint32_t temp;
+	temp = pSSP->CR0 & (~(SSP_CR0_SCR(0xFF)));
+	pSSP->CR0 = temp | (SSP_CR0_SCR(clk_rate));
+	pSSP->CPSR = prescale;
+}
+
+/* SSP Polling Read/Write in blocking mode */
+uint32_t Chip_SSP_RWFrames_Blocking(LPC_SSP_T *pSSP, Chip_SSP_DATA_SETUP_T *xf_setup)
+{
+	uint32_t size = (Chip_SSP_GetDataSize(pSSP) > SSP_BITS_8) ? 2 : 1;
+	uint32_t frames = (xf_setup->length - xf_setup->rx_cnt) / size;
+	uint8_t *tx = NULL, *rx = NULL;
+	uint32_t done;
+
+	if (xf_setup->tx_data) {
+		tx = (uint8_t *) xf_setup->tx_data + xf_setup->tx_cnt;
+	}
+	if (xf_setup->rx_data) {
+		rx = (uint8_t *) xf_setup->rx_data + xf_setup->rx_cnt;
+	}
+
+	SSP_BlockingStart(pSSP);
+	if (size == 2) {
+		done = SSP_Blocking16(pSSP, (const uint16_t *) tx, (uint16_t *) rx, frames);
+	}
 	else {
-		uint8_t *rdata8;
+		done = SSP_Blocking8(pSSP, tx, rx, frames);
+	}
+	xf_setup->rx_cnt += done * size;
+	xf_setup->tx_cnt = xf_setup->rx_cnt;
 
-		rdata8 = buffer;
+	if (done != frames) {
+		return ERROR;
+	}
+	if (xf_setup->tx_data) {
+		return xf_setup->tx_cnt;
+	}
+	else if (xf_setup->rx_data) {
+		return xf_setup->rx_cnt;
+	}
 
-		while (tx_cnt < buffer_len || rx_cnt < buffer_len) {
-			/* write data to buffer */
-			if ((Chip_SSP_GetStatus(pSSP, SSP_STAT_TNF) == SET) && (tx_cnt < buffer_len)) {
-				Chip_SSP_SendFrame(pSSP, 0xFF);	/* just send dummy data		 */
-				tx_cnt++;
-			}
+	return 0;
+}
 
-			/* Check overrun error */
-			if (Chip_SSP_GetRawIntStatus(pSSP, SSP_RORRIS) == SET) {
-				return ERROR;
-			}
+/* SSP Polling Write in blocking mode */
+uint32_t Chip_SSP_WriteFrames_Blocking(LPC_SSP_T *pSSP, uint8_t *buffer, uint32_t buffer_len)
+{
+	uint32_t frames, done;
 
-			/* Check for any data available in RX FIFO */
-			while (Chip_SSP_GetStatus(pSSP, SSP_STAT_RNE) == SET && rx_cnt < buffer_len) {
-				*rdata8 = Chip_SSP_ReceiveFrame(pSSP);
-				rdata8++;
-				rx_cnt++;
-			}
-		}
+	SSP_BlockingStart(pSSP);
+	if (Chip_SSP_GetDataSize(pSSP) > SSP_BITS_8) {
+		frames = buffer_len / 2;
+		done = SSP_Blocking16(pSSP, (const uint16_t *) buffer, NULL, frames);
+		return (done == frames) ? (done * 2) : ERROR;
 	}
 
-	return rx_cnt;
+	frames = buffer_len;
+	done = SSP_Blocking8(pSSP, buffer, NULL, frames);
+	return (done == frames) ? done : ERROR;
+}
+
+/* SSP Polling Read in blocking mode */
+uint32_t Chip_SSP_ReadFrames_Blocking(LPC_SSP_T *pSSP, uint8_t *buffer, uint32_t buffer_len)
+{
+	uint32_t frames, done;
+
+	SSP_BlockingStart(pSSP);
+	if (Chip_SSP_GetDataSize(pSSP) > SSP_BITS_8) {
+		frames = buffer_len / 2;
+		done = SSP_Blocking16(pSSP, NULL, (uint16_t *) buffer, frames);
+		return (done == frames) ? (done * 2) : ERROR;
+	}
 
+	frames = buffer_len;
+	done = SSP_Blocking8(pSSP, NULL, buffer, frames);
+	return (done == frames) ? done : ERROR;
 }
 
 /* Clean all data in RX FIFO of SSP */
@@ -457,28 +651,144 @@ void Chip_SSP_SetMaster(LPC_SSP_T *pSSP, bool master)
 }
 
 /* Set the clock frequency for SSP interface */
-void Chip_SSP_SetBitRate(LPC_SSP_T *pSSP, uint32_t bitRate)
+uint32_t Chip_SSP_SetBitRate(LPC_SSP_T *pSSP, uint32_t bitRate)
 {
-	uint32_t ssp_clk, cr0_div, cmp_clk, prescale;
+	SSP_CLOCK_T clk;
+
+	if (Chip_SSP_CalcBitRate(Chip_Clock_GetMainClockRate(), bitRate, &clk) != SUCCESS) {
+		return 0;
+	}
 
-	ssp_clk = Chip_SSP_GetPCLKkRate(pSSP);
+	Chip_SSP_SetSSPClkDivider(pSSP, clk.clkDiv);
+	Chip_SSP_SetClockRate(pSSP, clk.scr, clk.cpsr);
+	return clk.bitRate;
+}
 
-	cr0_div = 0;
-	cmp_clk = 0xFFFFFFFF;
-	prescale = 2;
+/* Find the SSP clock divider, prescale and SCR values for a bit rate */
+Status Chip_SSP_CalcBitRate(uint32_t clkin, uint32_t bitRate, SSP_CLOCK_T *pClk)
+{
+	return SSP_SolveDividers(clkin, bitRate, 255, pClk);
+}
 
-	while (cmp_clk > bitRate) {
-		cmp_clk = ssp_clk / ((cr0_div + 1) * prescale);
-		if (cmp_clk > bitRate) {
-			cr0_div++;
-			if (cr0_div > 0xFF) {
-				cr0_div = 0;
-				prescale += 2;
-			}
+/* Queue an interrupt driven SSP master transaction */
+void Chip_SSP_JobSubmit(LPC_SSP_T *pSSP, SSP_JOB_T *job)
+{
+	uint32_t primask;
+	uint32_t cr0_div, prescale;
+
+	/* Work out the clock setup here, not in the interrupt */
+	if (job->bitRate) {
+		SSP_CalcClockRate(pSSP, job->bitRate, &cr0_div, &prescale);
+		job->cr0 = SSP_CR0_SCR(cr0_div);
+		job->cpsr = prescale;
+	}
+	else {
+		job->cr0 = pSSP->CR0 & SSP_CR0_SCR(0xFF);
+		job->cpsr = pSSP->CPSR;
+	}
+	job->cr0 |= job->format.bits | job->format.frameFormat | job->format.clockMode;
+	job->xf.tx_cnt = 0;
+	job->xf.rx_cnt = 0;
+	job->status = SSP_JOB_BUSY;
+	job->next = NULL;
+
+	/* The queue is also updated from the SSP interrupt */
+	primask = __get_PRIMASK();
+	__disable_irq();
+	if (sspJob) {
+		sspJobTail->next = job;
+		sspJobTail = job;
+	}
+	else {
+		sspJob = sspJobTail = job;
+		Chip_SSP_ClearIntPending(pSSP, SSP_INT_CLEAR_BITMASK);
+		SSP_JobStart(pSSP, job);
+		pSSP->IMSC |= SSP_JOB_INTS;
+	}
+	if (!primask) {
+		__enable_irq();
+	}
+}
+
+/* Check if SSP jobs are queued */
+int Chip_SSP_JobsPending(LPC_SSP_T *pSSP)
+{
+	/* The LPC122x has a single SSP */
+	(void) pSSP;
+	return sspJob != NULL;
+}
+
+/* SSP interrupt handler for queued jobs */
+void Chip_SSP_JobIRQHandler(LPC_SSP_T *pSSP)
+{
+	if (!sspJob) {
+		pSSP->IMSC &= ~SSP_JOB_INTS;
+		return;
+	}
+
+	if (Chip_SSP_GetRawIntStatus(pSSP, SSP_RORRIS) == SET) {
+		Chip_SSP_Int_FlushData(pSSP);
+		SSP_JobFinish(pSSP, SSP_JOB_OVERRUN);
+		return;
+	}
+
+	Chip_SSP_ClearIntPending(pSSP, SSP_INT_CLEAR_BITMASK);
+	SSP_JobPump(pSSP, sspJob);
+	if (sspJob->xf.rx_cnt >= sspJob->xf.length) {
+		SSP_JobFinish(pSSP, SSP_JOB_DONE);
+	}
+}
+
+/* Full-duplex SSP transfer using DMA (non-blocking) */
+Status Chip_SSP_TransferDMA(LPC_SSP_T *pSSP, const void *tx_data, void *rx_data, uint32_t numFrames,
+							SSP_DMA_CALLBACK_T callback)
+{
+	if (sspDMA.busy) {
+		return ERROR;
+	}
+
+	sspDMA.callback = callback;
+	sspDMA.txData = (const uint8_t *) tx_data;
+	sspDMA.rxData = (uint8_t *) rx_data;
+	sspDMA.framesLeft = numFrames;
+	sspDMA.frameSize = (Chip_SSP_GetDataSize(pSSP) > SSP_BITS_8) ? 2 : 1;
+	if (numFrames == 0) {
+		if (callback) {
+			callback(pSSP, SSP_DMA_EVENT_DONE);
 		}
+		return SUCCESS;
 	}
+	sspDMA.busy = true;
+
+	/* Start from empty FIFOs */
+	Chip_SSP_Int_FlushData(pSSP);
 
-	Chip_SSP_SetClockRate(pSSP, cr0_div, prescale);
+	Chip_DMA_SetCallback(DMA_CH_SSP0_RX, SSP_DMARxCallback);
+	Chip_DMA_SetCallback(DMA_CH_SSP0_TX, SSP_DMATxCallback);
+	Chip_DMA_SetHighPriority(LPC_DMA, DMA_CH_SSP0_RX, true);
+	SSP_DMASendChunk(pSSP);
+	pSSP->DMACR = SSP_DMA_RXDMAE | SSP_DMA_TXDMAE;
+
+	return SUCCESS;
+}
+
+/* Check if a DMA transfer is in progress */
+bool Chip_SSP_IsDMABusy(LPC_SSP_T *pSSP)
+{
+	/* The LPC122x has a single SSP */
+	(void) pSSP;
+	return sspDMA.busy;
+}
+
+/* Stop a DMA transfer */
+void Chip_SSP_StopDMA(LPC_SSP_T *pSSP)
+{
+	pSSP->DMACR = 0;
+	Chip_DMA_Abort(LPC_DMA, DMA_CH_SSP0_TX);
+	Chip_DMA_Abort(LPC_DMA, DMA_CH_SSP0_RX);
+	sspDMA.framesLeft = 0;
+	sspDMA.busy = false;
+	Chip_SSP_Int_FlushData(pSSP);
 }
 
 /* Initialize the SSP */
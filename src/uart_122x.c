@@ -29,12 +29,50 @@
  * this code.
  */
 
+#include <string.h>
 #include "chip.h"
 
 /*****************************************************************************
  * Private types/enumerations/variables
  ****************************************************************************/
 
+/* RX FIFO depth guaranteed by each UART_FCR_TRG_LEVx trigger level */
+STATIC const uint8_t uartRxTrigDepth[4] = {1, 4, 8, 14};
+
+/* Current FIFO setup per UART without the reset bits, FCR cannot be read back */
+STATIC uint8_t uartFCR[2] = {UART_FCR_FIFO_EN, UART_FCR_FIFO_EN};
+
+/* DMA transfer state per UART */
+typedef struct {
+	UART_DMA_CALLBACK_T callback;	/* Event callback */
+	const uint8_t *txData;			/* Next transmit byte not yet handed to the DMA */
+	volatile int txLeft;			/* Transmit bytes not yet handed to the DMA */
+	volatile bool txBusy;			/* Chip_UART_SendDMA() in progress */
+	uint8_t *rxBuf;					/* Circular receive buffer */
+	uint32_t rxHalf;				/* Size of each ping-pong half */
+	volatile uint32_t rxBlocks;		/* Number of halves filled by the DMA */
+	uint32_t rxRead;				/* Number of bytes read by the application */
+	volatile bool rxOverrun;		/* Received data was dropped */
+	uint8_t rxTrigLevel;			/* RX trigger level to restore when reception stops */
+} UART_DMA_STATE_T;
+
+STATIC UART_DMA_STATE_T uartDMA[2];
+
+/* Framed receive state per UART */
+typedef struct {
+	UART_FRAME_SETUP_T setup;		/* Copy of the application setup */
+	int numSlots;					/* Number of slots in the frame pool */
+	int slot;						/* Slot being filled */
+	int len;						/* Bytes in the frame being received */
+	uint16_t flags;					/* UART_FRAME_* flags of the frame being received */
+	uint32_t dropped;				/* Frames dropped on a full queue */
+} UART_FRAME_STATE_T;
+
+STATIC UART_FRAME_STATE_T uartFrame[2];
+
+/* RS-485 software address match state per UART */
+STATIC volatile bool uartRS485Addressed[2];
+
 /*****************************************************************************
  * Public types/enumerations/variables
  ****************************************************************************/
@@ -43,6 +81,154 @@
  * Private functions
  ****************************************************************************/
 
+/* Returns the driver index of a UART */
+STATIC INLINE int getUARTIndex(LPC_USART_T *pUART)
+{
+	return (pUART == LPC_USART0) ? 0 : 1;
+}
+
+/* Returns the UART of a driver index */
+STATIC INLINE LPC_USART_T *getUART(int index)
+{
+	return (index == 0) ? LPC_USART0 : LPC_USART1;
+}
+
+/* Returns the RX FIFO depth guaranteed by the current trigger level */
+STATIC INLINE int getRxDepth(int index)
+{
+	return uartRxTrigDepth[(uartFCR[index] >> UART_FCR_TRG_LEV_SHIFT) & 0x3];
+}
+
+/* Drain the receive FIFO into a byte ring buffer. The first 'known' bytes
+   are known to be in the FIFO and are read without polling LSR, the ring
+   buffer head is only updated once at the end. */
+STATIC void uartDrainRB(LPC_USART_T *pUART, RINGBUFF_T *pRB, int known)
+{
+	RINGBUFF_SPAN_T span[2];
+	uint8_t *p8;
+	int room, seg, cnt = 0;
+
+	room = RingBuffer_ReserveWrite(pRB, span);
+	p8 = (uint8_t *) span[0].data;
+	seg = span[0].count;
+
+	while ((known-- > 0) || (Chip_UART_ReadLineStatus(pUART) & UART_LSR_RDR)) {
+		uint8_t ch = Chip_UART_ReadByte(pUART);
+
+		/* New data will be ignored if data not popped in time */
+		if (cnt < room) {
+			if (seg == 0) {
+				p8 = (uint8_t *) span[1].data;
+				seg = span[1].count;
+			}
+			*p8++ = ch;
+			seg--;
+			cnt++;
+		}
+	}
+
+	RingBuffer_CommitWrite(pRB, cnt);
+}
+
+/* Hand the next transmit chunk to the DMA */
+STATIC void uartDMASendChunk(int index)
+{
+	UART_DMA_STATE_T *pState = &uartDMA[index];
+	const uint8_t *p8 = pState->txData;
+	int cnt = MIN(pState->txLeft, DMA_MAX_XFER);
+
+	pState->txData += cnt;
+	pState->txLeft -= cnt;
+	Chip_DMA_Transfer(LPC_DMA, (DMA_CHID_T) (DMA_CH_UART0_TX + (2 * index)),
+					  (DMA_CTRL_CYCLE_BASIC | DMA_XFER_MEM2PER_8), p8, &getUART(index)->THR, cnt);
+}
+
+/* Report a UART DMA event */
+STATIC void uartDMANotify(int index, UART_DMA_EVENT_T event)
+{
+	if (uartDMA[index].callback != NULL) {
+		uartDMA[index].callback(getUART(index), event);
+	}
+}
+
+/* Number of bytes written by the receive DMA. Reading the completed block
+   count before the descriptor can only undercount if a half completes in
+   between. */
+STATIC uint32_t uartDMARxWritten(UART_DMA_STATE_T *pState, int index)
+{
+	uint32_t blocks = pState->rxBlocks;
+	DMA_CHDESC_T *pDesc = Chip_DMA_GetDesc((DMA_CHID_T) (DMA_CH_UART0_RX + (2 * index)), (blocks & 1) != 0);
+
+	return (blocks * pState->rxHalf) + (pState->rxHalf - Chip_DMA_GetDescRemaining(pDesc));
+}
+
+/* Transmit DMA channel callback */
+STATIC void uartDMATxCallback(DMA_CHID_T ch, DMA_EVENT_T event)
+{
+	int index = ch >> 1;
+	UART_DMA_STATE_T *pState = &uartDMA[index];
+
+	if (event == DMA_EVENT_ERROR) {
+		pState->txLeft = 0;
+		pState->txBusy = false;
+		uartDMANotify(index, UART_DMA_EVENT_ERROR);
+	}
+	else if (pState->txLeft > 0) {
+		uartDMASendChunk(index);
+	}
+	else {
+		pState->txBusy = false;
+		uartDMANotify(index, UART_DMA_EVENT_TX_DONE);
+	}
+}
+
+/* Receive DMA channel callback, hands the filled half straight back to the
+   controller */
+STATIC void uartDMARxCallback(DMA_CHID_T ch, DMA_EVENT_T event)
+{
+	int index = ch >> 1;
+	UART_DMA_STATE_T *pState = &uartDMA[index];
+
+	if (event == DMA_EVENT_ERROR) {
+		uartDMANotify(index, UART_DMA_EVENT_ERROR);
+		return;
+	}
+
+	pState->rxBlocks++;
+	Chip_DMA_ReloadDesc(Chip_DMA_GetDesc(ch, event == DMA_EVENT_ALT_DONE));
+	uartDMANotify(index, UART_DMA_EVENT_RX_BLOCK);
+}
+
+/* Move the receive FIFO into the current frame */
+STATIC void uartFrameDrain(LPC_USART_T *pUART, UART_FRAME_STATE_T *pState)
+{
+	uint8_t *p8 = pState->setup.pool + (pState->slot * pState->setup.slotSize);
+	uint32_t lsr;
+
+	while ((lsr = Chip_UART_ReadLineStatus(pUART)) & UART_LSR_RDR) {
+		uint8_t ch = Chip_UART_ReadByte(pUART);
+
+		if (lsr & (UART_LSR_OE | UART_LSR_PE | UART_LSR_FE | UART_LSR_BI)) {
+			pState->flags |= UART_FRAME_LINE_ERROR;
+		}
+		if (pState->len < pState->setup.slotSize) {
+			p8[pState->len++] = ch;
+		}
+		else {
+			pState->flags |= UART_FRAME_TRUNCATED;
+		}
+	}
+}
+
+/* Restart the gap timer from 0 */
+STATIC void uartFrameRestartTimer(LPC_TIMER_T *pTimer)
+{
+	pTimer->TCR = 0;
+	pTimer->PC = 0;
+	pTimer->TC = 0;
+	pTimer->TCR = TIMER_ENABLE;
+}
+
 /*****************************************************************************
  * Public functions
  ****************************************************************************/
@@ -85,6 +271,14 @@ void Chip_UART_DeInit(LPC_USART_T *pUART)
 	}
 }
 
+/* Setup the UART FIFOs */
+void Chip_UART_SetupFIFOS(LPC_USART_T *pUART, uint32_t fcr)
+{
+	pUART->FCR = fcr;
+
+	uartFCR[getUARTIndex(pUART)] = (uint8_t) (fcr & ~(UART_FCR_RX_RS | UART_FCR_TX_RS));
+}
+
 /* Transmit a byte array through the UART peripheral (non-blocking) */
 int Chip_UART_Send(LPC_USART_T *pUART, const void *data, int numBytes)
 {
@@ -151,48 +345,137 @@ int Chip_UART_ReadBlocking(LPC_USART_T *pUART, void *data, int numBytes)
 	return readBytes;
 }
 
-/* Determines and sets best dividers to get a target bit rate */
-uint32_t Chip_UART_SetBaud(LPC_USART_T *pUART, uint32_t baudrate)
+/* Get the UART peripheral clock rate */
+uint32_t Chip_UART_GetClockRate(LPC_USART_T *pUART)
 {
-	uint32_t div, divh, divl, clkin;
+	uint32_t div;
 
-	/* Determine UART clock in rate without FDR */
-	clkin = Chip_Clock_GetMainClockRate();
-	div = clkin / (baudrate * 16);
+	if (pUART == LPC_USART0) {
+		div = Chip_Clock_GetUART0ClockDiv();
+	}
+	else {
+		div = Chip_Clock_GetUART1ClockDiv();
+	}
+	if (div == 0) {
+		return 0;
+	}
+
+	return Chip_Clock_GetMainClockRate() / div;
+}
 
-	/* High and low halves of the divider */
-	divh = div / 256;
-	divl = div - (divh * 256);
+/* Find the dividers giving the closest rate to a target baud rate */
+Status Chip_UART_CalcBaud(uint32_t clkin, uint32_t baudrate, bool useFDR, UART_BAUD_T *pBaud)
+{
+	uint64_t num, den, diff, bestDiff = 0, bestDen = 1;
+	uint32_t mul, add, dl, dlCalc, minDl;
+	int i;
+	bool found = false;
 
+	if ((clkin == 0) || (baudrate == 0)) {
+		return ERROR;
+	}
+
+	/* baud = clkin * MULVAL / (16 * DL * (MULVAL + DIVADDVAL)) */
+	for (mul = 1; mul <= (useFDR ? 15 : 1); mul++) {
+		for (add = 0; add < mul; add++) {
+			if ((mul > 1) && (add == 0)) {
+				continue;	/* Same as MULVAL = 1 */
+			}
+
+			/* The fractional divider needs DL >= 3 */
+			minDl = (add > 0) ? 3 : 1;
+			num = (uint64_t) clkin * mul;
+			dlCalc = (uint32_t) (num / ((uint64_t) 16 * baudrate * (mul + add)));
+
+			/* The best DL for this ratio is on either side of the exact value */
+			for (i = 0; i < 2; i++) {
+				dl = dlCalc + i;
+				if ((dl < minDl) || (dl > 0xFFFF)) {
+					continue;
+				}
+				den = (uint64_t) 16 * dl * (mul + add);
+				diff = (num > (den * baudrate)) ? (num - (den * baudrate)) : ((den * baudrate) - num);
+
+				/* Compare diff / den against bestDiff / bestDen */
+				if (!found || ((diff * bestDen) < (bestDiff * den))) {
+					found = true;
+					bestDiff = diff;
+					bestDen = den;
+					pBaud->dl = (uint16_t) dl;
+					pBaud->divAddVal = (uint8_t) add;
+					pBaud->mulVal = (uint8_t) mul;
+				}
+			}
+		}
+	}
+	if (!found) {
+		return ERROR;
+	}
+
+	num = (uint64_t) clkin * pBaud->mulVal;
+	den = (uint64_t) 16 * pBaud->dl * (pBaud->mulVal + pBaud->divAddVal);
+	pBaud->baudrate = (uint32_t) ((num + (den / 2)) / den);
+	pBaud->errorPpm = (int32_t) (((int64_t) ((num * 1000000) / den) - ((int64_t) baudrate * 1000000)) / baudrate);
+
+	if ((pBaud->errorPpm > UART_BAUD_MAX_ERROR_PPM) || (pBaud->errorPpm < -UART_BAUD_MAX_ERROR_PPM)) {
+		return ERROR;
+	}
+	return SUCCESS;
+}
+
+/* Program the baud rate dividers of a UART */
+void Chip_UART_SetBaudDividers(LPC_USART_T *pUART, const UART_BAUD_T *pBaud)
+{
 	Chip_UART_EnableDivisorAccess(pUART);
-	Chip_UART_SetDivisorLatches(pUART, divl, divh);
+	Chip_UART_SetDivisorLatches(pUART, UART_LOAD_DLL(pBaud->dl), UART_LOAD_DLM(pBaud->dl));
 	Chip_UART_DisableDivisorAccess(pUART);
 
-	/* Fractional FDR alreadt setup for 1 in UART init */
+	pUART->FDR = (UART_FDR_MULVAL(pBaud->mulVal) | UART_FDR_DIVADDVAL(pBaud->divAddVal));
+}
 
-	return clkin / div / 16;
+/* Determines and sets best dividers to get a target bit rate */
+uint32_t Chip_UART_SetBaud(LPC_USART_T *pUART, uint32_t baudrate)
+{
+	UART_BAUD_T baud;
+
+	if (Chip_UART_CalcBaud(Chip_UART_GetClockRate(pUART), baudrate, false, &baud) == ERROR) {
+		return 0;
+	}
+
+	Chip_UART_SetBaudDividers(pUART, &baud);
+	return baud.baudrate;
 }
 
 /* UART receive-only interrupt handler for ring buffers */
 void Chip_UART_RXIntHandlerRB(LPC_USART_T *pUART, RINGBUFF_T *pRB)
 {
-	/* New data will be ignored if data not popped in time */
-	while (Chip_UART_ReadLineStatus(pUART) & UART_LSR_RDR) {
-		uint8_t ch = Chip_UART_ReadByte(pUART);
-		RingBuffer_Insert(pRB, &ch);
-	}
+	uartDrainRB(pUART, pRB, 0);
 }
 
 /* UART transmit-only interrupt handler for ring buffers */
 void Chip_UART_TXIntHandlerRB(LPC_USART_T *pUART, RINGBUFF_T *pRB)
 {
-	uint8_t ch;
+	RINGBUFF_SPAN_T span[2];
+	const uint8_t *p8;
+	int cnt, seg, sent;
+
+	/* THRE means the whole transmit FIFO is empty, so fill it in one go */
+	if ((Chip_UART_ReadLineStatus(pUART) & UART_LSR_THRE) == 0) {
+		return;
+	}
+
+	cnt = MIN(RingBuffer_PeekRead(pRB, span), UART_TX_FIFO_SIZE);
+	seg = MIN(cnt, span[0].count);
+	p8 = (const uint8_t *) span[0].data;
 
-	/* Fill FIFO until full or until TX ring buffer is empty */
-	while ((Chip_UART_ReadLineStatus(pUART) & UART_LSR_THRE) != 0 &&
-		   RingBuffer_Pop(pRB, &ch)) {
-		Chip_UART_SendByte(pUART, ch);
+	for (sent = 0; sent < cnt; sent++) {
+		if (sent == seg) {
+			p8 = (const uint8_t *) span[1].data;
+		}
+		Chip_UART_SendByte(pUART, *p8++);
 	}
+
+	RingBuffer_ConsumeRead(pRB, cnt);
 }
 
 /* Populate a transmit ring buffer and start UART transmit */
@@ -201,11 +484,14 @@ uint32_t Chip_UART_SendRB(LPC_USART_T *pUART, RINGBUFF_T *pRB, const void *data,
 	uint32_t ret;
 	uint8_t *p8 = (uint8_t *) data;
 
-	/* Don't let UART transmit ring buffer change in the UART IRQ handler */
-	Chip_UART_IntDisable(pUART, UART_IER_THREINT);
-
-	/* Move as much data as possible into transmit ring buffer */
+	/* Move as much data as possible into transmit ring buffer, the ring
+	   buffer is SPSC safe so the IRQ handler may keep draining it */
 	ret = RingBuffer_InsertMult(pRB, p8, bytes);
+
+	/* Only the FIFO kick below consumes from the ring buffer outside of
+	   the IRQ handler, so only that part runs with the transmit interrupt
+	   masked */
+	Chip_UART_IntDisable(pUART, UART_IER_THREINT);
 	Chip_UART_TXIntHandlerRB(pUART, pRB);
 
 	/* Add additional data to transmit ring buffer if possible */
@@ -228,6 +514,8 @@ int Chip_UART_ReadRB(LPC_USART_T *pUART, RINGBUFF_T *pRB, void *data, int bytes)
 /* UART receive/transmit interrupt handler for ring buffers */
 void Chip_UART_IRQRBHandler(LPC_USART_T *pUART, RINGBUFF_T *pRXRB, RINGBUFF_T *pTXRB)
 {
+	uint32_t iir = Chip_UART_ReadIntIDReg(pUART);
+
 	/* Handle transmit interrupt if enabled */
 	if (pUART->IER & UART_IER_THREINT) {
 		Chip_UART_TXIntHandlerRB(pUART, pTXRB);
@@ -238,60 +526,393 @@ void Chip_UART_IRQRBHandler(LPC_USART_T *pUART, RINGBUFF_T *pRXRB, RINGBUFF_T *p
 		}
 	}
 
-	/* Handle receive interrupt */
-	Chip_UART_RXIntHandlerRB(pUART, pRXRB);
+	/* Handle receive interrupt, a receive data available interrupt means
+	   the RX FIFO holds at least the trigger level worth of bytes */
+	if ((iir & UART_IIR_INTID_MASK) == UART_IIR_INTID_RDA) {
+		uartDrainRB(pUART, pRXRB, getRxDepth(getUARTIndex(pUART)));
+	}
+	else {
+		uartDrainRB(pUART, pRXRB, 0);
+	}
 }
 
 /* Determines and sets best dividers to get a target baud rate */
 uint32_t Chip_UART_SetBaudFDR(LPC_USART_T *pUART, uint32_t baudrate)
+{
+	UART_BAUD_T baud;
+
+	if (Chip_UART_CalcBaud(Chip_UART_GetClockRate(pUART), baudrate, true, &baud) == ERROR) {
+		return 0;
+	}
+
+	Chip_UART_SetBaudDividers(pUART, &baud);
+	return baud.baudrate;
+}
 
+/* Register the DMA event callback of a UART */
+void Chip_UART_SetDMACallback(LPC_USART_T *pUART, UART_DMA_CALLBACK_T callback)
 {
-	uint32_t uClk;
-    uint32_t dval, mval;
-    uint32_t dl;
-    uint32_t rate16 = 16 * baudrate;
-	uint32_t actualRate = 0;
-
-	/* Get Clock rate */
-	uClk = Chip_Clock_GetMainClockRate();
-
-    /* The fractional is calculated as (PCLK  % (16 * Baudrate)) / (16 * Baudrate)
-     * Let's make it to be the ratio DivVal / MulVal
-     */
-	dval = uClk % rate16;
-
-   /* The PCLK / (16 * Baudrate) is fractional
-    * => dval = pclk % rate16
-    * mval = rate16;
-    * now mormalize the ratio
-    * dval / mval = 1 / new_mval
-    * new_mval = mval / dval
-    * new_dval = 1
-    */
-    if (dval > 0) {
-        mval = rate16 / dval;
-        dval = 1;
-
-        /* In case mval still bigger then 4 bits
-        * no adjustment require
-        */
-        if (mval > 12) {
-         dval = 0;
-      }
-    }
-    dval &= 0xf;
-    mval &= 0xf;
-    dl = uClk / (rate16 + rate16 *dval / mval);
-
-    /* Update UART registers */
-    Chip_UART_EnableDivisorAccess(pUART);
-	Chip_UART_SetDivisorLatches(pUART, UART_LOAD_DLL(dl), UART_LOAD_DLM(dl));
-	Chip_UART_DisableDivisorAccess(pUART);
+	uartDMA[getUARTIndex(pUART)].callback = callback;
+}
 
-	/* Set best fractional divider */
-	pUART->FDR = (UART_FDR_MULVAL(mval) | UART_FDR_DIVADDVAL(dval));
+/* Transmit a byte array through the UART using DMA (non-blocking) */
+Status Chip_UART_SendDMA(LPC_USART_T *pUART, const void *data, int numBytes)
+{
+	int index = getUARTIndex(pUART);
+	UART_DMA_STATE_T *pState = &uartDMA[index];
 
-	/* Return actual baud rate */
-	actualRate = uClk / (16 * dl + 16 * dl * dval / mval);
-	return actualRate;
+	if (pState->txBusy) {
+		return ERROR;
+	}
+	if (numBytes <= 0) {
+		return SUCCESS;
+	}
+
+	if ((uartFCR[index] & UART_FCR_DMAMODE_SEL) == 0) {
+		Chip_UART_SetupFIFOS(pUART, uartFCR[index] | UART_FCR_DMAMODE_SEL);
+	}
+
+	pState->txData = (const uint8_t *) data;
+	pState->txLeft = numBytes;
+	pState->txBusy = true;
+	Chip_DMA_SetCallback((DMA_CHID_T) (DMA_CH_UART0_TX + (2 * index)), uartDMATxCallback);
+	uartDMASendChunk(index);
+
+	return SUCCESS;
+}
+
+/* Check if a DMA transmit is in progress */
+bool Chip_UART_IsSendDMABusy(LPC_USART_T *pUART)
+{
+	return uartDMA[getUARTIndex(pUART)].txBusy;
+}
+
+/* Start continuous DMA reception into a circular buffer */
+Status Chip_UART_ReceiveDMA(LPC_USART_T *pUART, void *buffer, int size)
+{
+	int index = getUARTIndex(pUART);
+	UART_DMA_STATE_T *pState = &uartDMA[index];
+	DMA_CHID_T ch = (DMA_CHID_T) (DMA_CH_UART0_RX + (2 * index));
+	const volatile void *src[2];
+	volatile void *dst[2];
+
+	if ((size < 2) || (size > (2 * DMA_MAX_XFER)) || ((size & (size - 1)) != 0)) {
+		return ERROR;
+	}
+
+	Chip_DMA_Abort(LPC_DMA, ch);
+	if (pState->rxBuf == NULL) {
+		pState->rxTrigLevel = uartFCR[index] & UART_FCR_TRG_LEV3;
+	}
+	pState->rxBuf = (uint8_t *) buffer;
+	pState->rxHalf = size / 2;
+	pState->rxBlocks = 0;
+	pState->rxRead = 0;
+	pState->rxOverrun = false;
+
+	src[0] = src[1] = &pUART->RBR;
+	dst[0] = pState->rxBuf;
+	dst[1] = pState->rxBuf + pState->rxHalf;
+	Chip_DMA_SetCallback(ch, uartDMARxCallback);
+	Chip_DMA_PingPong(LPC_DMA, ch, DMA_XFER_PER2MEM_8, src, dst, pState->rxHalf);
+
+	/* With the deepest trigger level the DMA keeps the FIFO below it, so the
+	   receive interrupt is effectively the character time-out only */
+	Chip_UART_SetupFIFOS(pUART, uartFCR[index] | UART_FCR_TRG_LEV3 | UART_FCR_DMAMODE_SEL |
+						 UART_FCR_RX_RS);
+	Chip_UART_IntEnable(pUART, UART_IER_RBRINT);
+
+	return SUCCESS;
+}
+
+/* Get the number of bytes received by DMA and not yet read */
+int Chip_UART_GetDMARxCount(LPC_USART_T *pUART)
+{
+	int index = getUARTIndex(pUART);
+	UART_DMA_STATE_T *pState = &uartDMA[index];
+	uint32_t avail;
+
+	if (pState->rxBuf == NULL) {
+		return 0;
+	}
+
+	avail = uartDMARxWritten(pState, index) - pState->rxRead;
+	return (int) MIN(avail, 2 * pState->rxHalf);
+}
+
+/* Copy data received by DMA out of the circular buffer */
+int Chip_UART_ReadDMA(LPC_USART_T *pUART, void *data, int numBytes)
+{
+	int index = getUARTIndex(pUART);
+	UART_DMA_STATE_T *pState = &uartDMA[index];
+	uint8_t *p8 = (uint8_t *) data;
+	uint32_t size = 2 * pState->rxHalf;
+	uint32_t avail, pos, cnt, seg;
+
+	if ((pState->rxBuf == NULL) || (numBytes <= 0)) {
+		return 0;
+	}
+
+	avail = uartDMARxWritten(pState, index) - pState->rxRead;
+	if (avail > size) {
+		/* The DMA lapped the reader, restart from the last completed half,
+		   which is the oldest data that is still intact */
+		pState->rxRead = (pState->rxBlocks - 1) * pState->rxHalf;
+		pState->rxOverrun = true;
+		avail = uartDMARxWritten(pState, index) - pState->rxRead;
+	}
+
+	cnt = MIN(avail, (uint32_t) numBytes);
+	pos = pState->rxRead & (size - 1);
+	seg = MIN(cnt, size - pos);
+	memcpy(p8, pState->rxBuf + pos, seg);
+	memcpy(p8 + seg, pState->rxBuf, cnt - seg);
+	pState->rxRead += cnt;
+
+	return (int) cnt;
+}
+
+/* Check and clear the DMA receive overrun flag */
+bool Chip_UART_CheckDMARxOverrun(LPC_USART_T *pUART)
+{
+	UART_DMA_STATE_T *pState = &uartDMA[getUARTIndex(pUART)];
+	bool overrun = pState->rxOverrun;
+
+	pState->rxOverrun = false;
+	return overrun;
+}
+
+/* Stop DMA transmit and receive on a UART */
+void Chip_UART_StopDMA(LPC_USART_T *pUART)
+{
+	int index = getUARTIndex(pUART);
+	UART_DMA_STATE_T *pState = &uartDMA[index];
+	uint32_t fcr = uartFCR[index] & ~UART_FCR_DMAMODE_SEL;
+
+	Chip_UART_IntDisable(pUART, UART_IER_RBRINT);
+	Chip_DMA_Abort(LPC_DMA, (DMA_CHID_T) (DMA_CH_UART0_TX + (2 * index)));
+	Chip_DMA_Abort(LPC_DMA, (DMA_CHID_T) (DMA_CH_UART0_RX + (2 * index)));
+	if (pState->rxBuf != NULL) {
+		fcr = (fcr & ~UART_FCR_TRG_LEV3) | pState->rxTrigLevel;
+	}
+	Chip_UART_SetupFIFOS(pUART, fcr);
+
+	pState->txLeft = 0;
+	pState->txBusy = false;
+	pState->rxBuf = NULL;
+}
+
+/* UART interrupt handler for DMA reception */
+void Chip_UART_DMAIRQHandler(LPC_USART_T *pUART)
+{
+	uint32_t iir = Chip_UART_ReadIntIDReg(pUART);
+
+	if ((iir & (UART_IIR_INTSTAT_PEND | UART_IIR_INTID_MASK)) == UART_IIR_INTID_CTI) {
+		uartDMANotify(getUARTIndex(pUART), UART_DMA_EVENT_RX_IDLE);
+	}
+}
+
+/* Start framed receive mode on a UART */
+Status Chip_UART_FrameInit(LPC_USART_T *pUART, const UART_FRAME_SETUP_T *pSetup)
+{
+	UART_FRAME_STATE_T *pState = &uartFrame[getUARTIndex(pUART)];
+	LPC_TIMER_T *pTimer = pSetup->pTimer;
+	uint64_t ticks;
+	uint32_t prescale;
+
+	if ((pSetup->pQueue->itemSz != sizeof(UART_FRAME_T)) || (pSetup->slotSize == 0) ||
+		(pSetup->gapUs == 0)) {
+		return ERROR;
+	}
+
+	/* Scale the 16-bit timer so that the gap fits in the match register */
+	ticks = ((uint64_t) Chip_Clock_GetSystemClockRate() * pSetup->gapUs) / 1000000;
+	prescale = (uint32_t) (ticks / 0x10000) + 1;
+	if (prescale > 0x10000) {
+		return ERROR;
+	}
+
+	Chip_UART_IntDisable(pUART, UART_IER_RBRINT | UART_IER_RLSINT);
+	pState->setup = *pSetup;
+	pState->numSlots = pSetup->pQueue->count + 2;
+	pState->slot = 0;
+	pState->len = 0;
+	pState->flags = 0;
+	pState->dropped = 0;
+
+	Chip_TIMER_Init(pTimer);
+	pTimer->TCR = 0;
+	pTimer->CTCR = 0;
+	Chip_TIMER_PrescaleSet(pTimer, prescale - 1);
+	Chip_TIMER_SetMatch(pTimer, 0, MAX((uint32_t) (ticks / prescale), 1));
+	pTimer->MCR = TIMER_INT_ON_MATCH(0) | TIMER_RESET_ON_MATCH(0) | TIMER_STOP_ON_MATCH(0);
+	Chip_TIMER_ClearMatch(pTimer, 0);
+
+	Chip_UART_IntEnable(pUART, UART_IER_RBRINT | UART_IER_RLSINT);
+
+	return SUCCESS;
+}
+
+/* Stop framed receive mode on a UART */
+void Chip_UART_FrameDeInit(LPC_USART_T *pUART)
+{
+	UART_FRAME_STATE_T *pState = &uartFrame[getUARTIndex(pUART)];
+
+	Chip_UART_IntDisable(pUART, UART_IER_RBRINT | UART_IER_RLSINT);
+	if (pState->setup.pTimer != NULL) {
+		pState->setup.pTimer->TCR = 0;
+		pState->setup.pTimer->MCR = 0;
+		Chip_TIMER_ClearMatch(pState->setup.pTimer, 0);
+	}
+}
+
+/* Get the next received frame */
+int Chip_UART_FrameRead(LPC_USART_T *pUART, UART_FRAME_T *pFrame)
+{
+	return RingBuffer_Pop(uartFrame[getUARTIndex(pUART)].setup.pQueue, pFrame);
+}
+
+/* Get the number of frames dropped because the frame queue was full */
+uint32_t Chip_UART_FrameGetDropped(LPC_USART_T *pUART)
+{
+	return uartFrame[getUARTIndex(pUART)].dropped;
+}
+
+/* UART interrupt handler for framed receive mode */
+void Chip_UART_FrameIRQHandler(LPC_USART_T *pUART)
+{
+	UART_FRAME_STATE_T *pState = &uartFrame[getUARTIndex(pUART)];
+
+	/* Reading IIR acknowledges a THRE interrupt, RDA, CTI and RLS are
+	   cleared by draining the FIFO */
+	(void) Chip_UART_ReadIntIDReg(pUART);
+	uartFrameDrain(pUART, pState);
+	if ((pState->len > 0) || (pState->flags != 0)) {
+		uartFrameRestartTimer(pState->setup.pTimer);
+	}
+}
+
+/* Gap timer interrupt handler for framed receive mode */
+void Chip_UART_FrameTimerIRQHandler(LPC_USART_T *pUART)
+{
+	UART_FRAME_STATE_T *pState = &uartFrame[getUARTIndex(pUART)];
+	UART_FRAME_T frame;
+
+	Chip_TIMER_ClearMatch(pState->setup.pTimer, 0);
+
+	/* Bytes below the trigger level that have not timed out yet */
+	if (Chip_UART_ReadLineStatus(pUART) & UART_LSR_RDR) {
+		uartFrameDrain(pUART, pState);
+		uartFrameRestartTimer(pState->setup.pTimer);
+		return;
+	}
+
+	if (pState->len > 0) {
+		frame.data = pState->setup.pool + (pState->slot * pState->setup.slotSize);
+		frame.len = (uint16_t) pState->len;
+		frame.flags = pState->flags;
+		if (RingBuffer_Insert(pState->setup.pQueue, &frame)) {
+			pState->slot = (pState->slot + 1) % pState->numSlots;
+		}
+		else {
+			pState->dropped++;
+		}
+	}
+
+	pState->len = 0;
+	pState->flags = 0;
+}
+
+/* Set up a UART for RS-485 with hardware direction control */
+void Chip_UART_RS485Init(LPC_USART_T *pUART, const UART_RS485_SETUP_T *pSetup)
+{
+	uint32_t ctrl = UART_RS485CTRL_DCTRL_EN |
+					(pSetup->options & (UART_RS485_DIR_DTR | UART_RS485_DIR_ACTIVE_HIGH));
+	uint32_t lcr = pUART->LCR & ~(UART_LCR_PARITY_EN | UART_LCR_PARITY_F_0 | UART_LCR_DLAB_EN);
+
+	pUART->RS485CTRL = 0;
+	uartRS485Addressed[getUARTIndex(pUART)] = false;
+
+	if (pSetup->options & (UART_RS485_MULTIDROP | UART_RS485_AUTO_ADDRESS)) {
+		/* Data bytes have the 9th bit cleared */
+		Chip_UART_ConfigData(pUART, lcr | UART_LCR_PARITY_EN | UART_LCR_PARITY_F_0);
+		Chip_UART_SetRS485Addr(pUART, pSetup->address);
+		ctrl |= UART_RS485CTRL_NMM_EN;
+		if (pSetup->options & UART_RS485_AUTO_ADDRESS) {
+			ctrl |= UART_RS485CTRL_AADEN | UART_RS485CTRL_RX_DIS;
+		}
+	}
+
+	Chip_UART_SetRS485Delay(pUART, pSetup->dirDelay);
+	pUART->RS485CTRL = ctrl;
+}
+
+/* Disable RS-485 mode on a UART */
+void Chip_UART_RS485DeInit(LPC_USART_T *pUART)
+{
+	pUART->RS485CTRL = 0;
+	Chip_UART_ConfigData(pUART, pUART->LCR & ~(UART_LCR_PARITY_EN | UART_LCR_PARITY_F_0 | UART_LCR_DLAB_EN));
+}
+
+/* Send a multidrop address byte (blocking) */
+void Chip_UART_RS485SendAddress(LPC_USART_T *pUART, uint8_t addr)
+{
+	uint32_t lcr = pUART->LCR & ~(UART_LCR_PARITY_F_0 | UART_LCR_DLAB_EN);
+
+	/* Parity is applied as characters are shifted out, so the 9th bit can
+	   only be changed while the transmitter is idle */
+	while (!Chip_UART_RS485IsTxIdle(pUART)) {}
+	Chip_UART_ConfigData(pUART, lcr | UART_LCR_PARITY_EN | UART_LCR_PARITY_F_1);
+	Chip_UART_SendByte(pUART, addr);
+
+	while (!Chip_UART_RS485IsTxIdle(pUART)) {}
+	Chip_UART_ConfigData(pUART, lcr | UART_LCR_PARITY_EN | UART_LCR_PARITY_F_0);
+}
+
+/* Ignore received data until this station is addressed again */
+void Chip_UART_RS485WaitAddress(LPC_USART_T *pUART)
+{
+	uartRS485Addressed[getUARTIndex(pUART)] = false;
+	if (pUART->RS485CTRL & UART_RS485CTRL_AADEN) {
+		Chip_UART_SetRS485Flags(pUART, UART_RS485CTRL_RX_DIS);
+	}
+}
+
+/* UART RS-485 interrupt handler for ring buffers */
+void Chip_UART_RS485IRQRBHandler(LPC_USART_T *pUART, RINGBUFF_T *pRXRB, RINGBUFF_T *pTXRB)
+{
+	int index = getUARTIndex(pUART);
+	uint32_t ctrl = pUART->RS485CTRL;
+	uint32_t lsr;
+	uint8_t ch;
+
+	(void) Chip_UART_ReadIntIDReg(pUART);
+
+	/* Handle transmit interrupt if enabled */
+	if (pUART->IER & UART_IER_THREINT) {
+		Chip_UART_TXIntHandlerRB(pUART, pTXRB);
+
+		/* Disable transmit interrupt if the ring buffer is empty */
+		if (RingBuffer_IsEmpty(pTXRB)) {
+			Chip_UART_IntDisable(pUART, UART_IER_THREINT);
+		}
+	}
+
+	/* Line status is needed per byte to spot address bytes */
+	while ((lsr = Chip_UART_ReadLineStatus(pUART)) & UART_LSR_RDR) {
+		ch = Chip_UART_ReadByte(pUART);
+
+		if ((ctrl & UART_RS485CTRL_NMM_EN) == 0) {
+			RingBuffer_InsertByte(pRXRB, ch);
+		}
+		else if (lsr & UART_LSR_PE) {
+			/* Address byte, the hardware already matched it in auto
+			   address mode */
+			uartRS485Addressed[index] = ((ctrl & UART_RS485CTRL_AADEN) != 0) ||
+										(ch == Chip_UART_GetRS485Addr(pUART));
+		}
+		else if (uartRS485Addressed[index] || (ctrl & UART_RS485CTRL_AADEN)) {
+			RingBuffer_InsertByte(pRXRB, ch);
+		}
+	}
 }
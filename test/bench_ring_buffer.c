@@ -0,0 +1,151 @@
+/*
+ * @brief Byte ring buffer cycle-count comparison
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2012
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "ring_buffer.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define RB_BYTES            256
+
+/* Byte ring buffer under test */
+static RINGBUFF_T rb;
+static uint8_t rbData[RB_BYTES];
+
+/* Number of bytes passed through each variant */
+static uint32_t numBytes = 10000000UL;
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Read a cycle counter, nanoseconds where the host has none */
+static uint64_t readCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __builtin_ia32_rdtsc();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+/* Pass bytes through the generic item path */
+static uint32_t runGeneric(void)
+{
+	uint32_t i, sum = 0;
+	uint8_t in, out = 0;
+
+	for (i = 0; i < numBytes; i++) {
+		in = (uint8_t) i;
+		RingBuffer_Insert(&rb, &in);
+		RingBuffer_Pop(&rb, &out);
+		sum += out;
+	}
+	return sum;
+}
+
+/* Pass bytes through the inline byte path with the runtime size */
+static uint32_t runByte(void)
+{
+	uint32_t i, sum = 0;
+	uint8_t out = 0;
+
+	for (i = 0; i < numBytes; i++) {
+		RingBuffer_InsertByte(&rb, (uint8_t) i);
+		RingBuffer_PopByte(&rb, &out);
+		sum += out;
+	}
+	return sum;
+}
+
+/* Pass bytes through the inline byte path with the compile-time size */
+static uint32_t runByteN(void)
+{
+	uint32_t i, sum = 0;
+	uint8_t out = 0;
+
+	for (i = 0; i < numBytes; i++) {
+		RingBuffer_InsertByteN(&rb, (uint8_t) i, RB_BYTES);
+		RingBuffer_PopByteN(&rb, &out, RB_BYTES);
+		sum += out;
+	}
+	return sum;
+}
+
+/* Time one variant and check that every byte came back */
+static int runVariant(const char *name, uint32_t (*run)(void), uint32_t expected)
+{
+	uint64_t start, cycles;
+	uint32_t sum;
+
+	RingBuffer_Init(&rb, rbData, 1, RB_BYTES);
+	start = readCycles();
+	sum = run();
+	cycles = readCycles() - start;
+
+	printf("%-32s %6.2f cycles/byte\n", name, (double) cycles / numBytes);
+	if ((sum != expected) || !RingBuffer_IsEmpty(&rb)) {
+		printf("FAIL: %s lost bytes\n", name);
+		return 1;
+	}
+	return 0;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Compare the insert + pop cost of the byte ring buffer variants */
+int main(int argc, char *argv[])
+{
+	uint32_t i, expected = 0;
+	int err = 0;
+
+	if (argc > 1) {
+		numBytes = (uint32_t) strtoul(argv[1], NULL, 0);
+	}
+	for (i = 0; i < numBytes; i++) {
+		expected += (uint8_t) i;
+	}
+
+	err |= runVariant("RingBuffer_Insert/Pop", runGeneric, expected);
+	err |= runVariant("RingBuffer_InsertByte/PopByte", runByte, expected);
+	err |= runVariant("RingBuffer_InsertByteN/PopByteN", runByteN, expected);
+
+	return err;
+}
@@ -0,0 +1,84 @@
+/*
+ * @brief Host stand-ins for the Cortex-M0 CMSIS intrinsics
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2012
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __HOST_CMSIS_H_
+#define __HOST_CMSIS_H_
+
+/* Force-included ahead of chip.h by the host tests. Defining the include
+   guards of the CMSIS intrinsic headers replaces their ARM inline assembly
+   with the plain C versions below. */
+#define __CORE_CMINSTR_H
+#define __CORE_CMFUNC_H
+
+#include <stdint.h>
+
+/* PRIMASK of the host "core", 1 while interrupts are masked */
+extern volatile uint32_t hostPrimask;
+
+/* Number of times interrupts have been masked */
+extern volatile uint32_t hostIrqDisables;
+
+static inline void __NOP(void) {}
+static inline void __WFI(void) {}
+static inline void __WFE(void) {}
+static inline void __SEV(void) {}
+static inline void __ISB(void) { __sync_synchronize(); }
+static inline void __DSB(void) { __sync_synchronize(); }
+static inline void __DMB(void) { __sync_synchronize(); }
+
+static inline uint32_t __REV(uint32_t value) { return __builtin_bswap32(value); }
+static inline uint32_t __REV16(uint32_t value)
+{
+	return ((value & 0xFF00FF00UL) >> 8) | ((value & 0x00FF00FFUL) << 8);
+}
+static inline int32_t __REVSH(int32_t value) { return (int16_t) __builtin_bswap16((uint16_t) value); }
+static inline uint32_t __ROR(uint32_t op1, uint32_t op2)
+{
+	op2 &= 31;
+	return (op2 == 0) ? op1 : ((op1 >> op2) | (op1 << (32 - op2)));
+}
+
+static inline void __enable_irq(void) { hostPrimask = 0; }
+static inline void __disable_irq(void) { hostPrimask = 1; hostIrqDisables++; }
+static inline uint32_t __get_PRIMASK(void) { return hostPrimask; }
+static inline void __set_PRIMASK(uint32_t priMask) { hostPrimask = priMask & 1; }
+
+static inline uint32_t __get_CONTROL(void) { return 0; }
+static inline void __set_CONTROL(uint32_t control) { (void) control; }
+static inline uint32_t __get_IPSR(void) { return 0; }
+static inline uint32_t __get_APSR(void) { return 0; }
+static inline uint32_t __get_xPSR(void) { return 0; }
+static inline uint32_t __get_PSP(void) { return 0; }
+static inline void __set_PSP(uint32_t topOfProcStack) { (void) topOfProcStack; }
+static inline uint32_t __get_MSP(void) { return 0; }
+static inline void __set_MSP(uint32_t topOfMainStack) { (void) topOfMainStack; }
+
+#endif /* __HOST_CMSIS_H_ */
@@ -0,0 +1,250 @@
+/*
+ * @brief CRC engine software fallback test
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2012
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <stdio.h>
+#include "crc_122x.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Check input of the CRC catalogue */
+static const char checkData[] = "123456789";
+
+/* Known checksums of the check input */
+static const struct {
+	const char *name;
+	CRC_POLY_T poly;
+	uint32_t flags;
+	uint32_t seed;
+	uint32_t check;
+} refTable[] = {
+	{"CRC-16/XMODEM", CRC_POLY_CCITT, 0, 0, 0x31C3},
+	{"CRC-16/GENIBUS", CRC_POLY_CCITT, CRC_MODE_SUM_CMPL, 0xFFFF, 0xD64E},
+	{"CRC-16/MODBUS", CRC_POLY_CRC16, CRC_MODE_WRDATA_BIT_RVS | CRC_MODE_SUM_BIT_RVS, 0xFFFF, 0x4B37},
+	{"CRC-16/UMTS", CRC_POLY_CRC16, 0, 0, 0xFEE8},
+	{"CRC-32/JAMCRC", CRC_POLY_CRC32, CRC_MODE_WRDATA_BIT_RVS | CRC_MODE_SUM_BIT_RVS, 0xFFFFFFFF,
+	 0x340BC6D9},
+	{"CRC-32/BZIP2", CRC_POLY_CRC32, CRC_MODE_SUM_CMPL, 0xFFFFFFFF, 0xFC891918},
+	{"CRC-32/MPEG-2", CRC_POLY_CRC32, 0, 0xFFFFFFFF, 0x0376E6E7},
+};
+
+/* Polynomials and widths for the bitwise reference */
+static const uint32_t polyValue[CRC_POLY_LAST] = {0x1021, 0x8005, 0x04C11DB7};
+static const uint32_t polyWidth[CRC_POLY_LAST] = {16, 16, 32};
+
+/* Default setup check values, CRC-16/CCITT-FALSE, CRC-16/ARC and CRC-32 */
+static const uint32_t defaultCheck[CRC_POLY_LAST] = {0x29B1, 0xBB3D, 0xCBF43926};
+
+static uint8_t data[256];
+static uint32_t rnd = 1;
+static int failures;
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Report a failed check */
+static void check(bool ok, const char *what, int poly, uint32_t flags)
+{
+	if (!ok) {
+		printf("  %s, polynomial %d, flags 0x%02lX\n", what, poly, (unsigned long) flags);
+		failures++;
+	}
+}
+
+/* Small pseudo random generator */
+static uint32_t nextRandom(void)
+{
+	rnd = (rnd * 1103515245) + 12345;
+	return rnd >> 8;
+}
+
+/* Reverse the low bits of a value */
+static uint32_t reverseBits(uint32_t v, uint32_t bits)
+{
+	uint32_t r = 0, i;
+
+	for (i = 0; i < bits; i++) {
+		r = (r << 1) | ((v >> i) & 1);
+	}
+	return r;
+}
+
+/* Bit at a time CRC with the CRC_MODE_* options, as described for the MODE
+   register */
+static uint32_t refCrc(CRC_POLY_T poly, uint32_t flags, uint32_t seed, const uint8_t *p, uint32_t len)
+{
+	uint32_t width = polyWidth[poly];
+	uint32_t mask = (width == 32) ? 0xFFFFFFFF : ((1UL << width) - 1);
+	uint32_t top = 1UL << (width - 1);
+	uint32_t sum = seed & mask;
+	uint32_t b, i;
+
+	while (len--) {
+		b = *p++;
+		if (flags & CRC_MODE_WRDATA_BIT_RVS) {
+			b = reverseBits(b, 8);
+		}
+		if (flags & CRC_MODE_WRDATA_CMPL) {
+			b ^= 0xFF;
+		}
+		sum ^= b << (width - 8);
+		for (i = 0; i < 8; i++) {
+			sum = ((sum & top) ? ((sum << 1) ^ polyValue[poly]) : (sum << 1)) & mask;
+		}
+	}
+	if (flags & CRC_MODE_SUM_BIT_RVS) {
+		sum = reverseBits(sum, width);
+	}
+	if (flags & CRC_MODE_SUM_CMPL) {
+		sum = ~sum & mask;
+	}
+
+	return sum;
+}
+
+/* Single feed software CRC */
+static uint32_t swCrc(CRC_POLY_T poly, uint32_t flags, uint32_t seed, const void *p, uint32_t len)
+{
+	CRC_SW_T crc;
+
+	Chip_CRC_SWInit(&crc, poly, flags, seed);
+	Chip_CRC_SWUpdate(&crc, p, len);
+	return Chip_CRC_SWSum(&crc);
+}
+
+/* Default setups against the check values */
+static void testDefaults(void)
+{
+	CRC_SW_T crc;
+	int p;
+
+	printf("Default setups\n");
+	for (p = 0; p < CRC_POLY_LAST; p++) {
+		Chip_CRC_SWDefault(&crc, (CRC_POLY_T) p);
+		Chip_CRC_SWUpdate(&crc, checkData, sizeof(checkData) - 1);
+		check(Chip_CRC_SWSum(&crc) == defaultCheck[p], "wrong check value", p, crc.mode);
+	}
+}
+
+/* Catalogue setups against their check values */
+static void testCatalogue(void)
+{
+	uint32_t i;
+
+	printf("Catalogue setups\n");
+	for (i = 0; i < sizeof(refTable) / sizeof(refTable[0]); i++) {
+		if (swCrc(refTable[i].poly, refTable[i].flags, refTable[i].seed, checkData,
+				  sizeof(checkData) - 1) != refTable[i].check) {
+			printf("  %s\n", refTable[i].name);
+			failures++;
+		}
+	}
+}
+
+/* Every combination of the options against the bitwise reference, and
+   each option on its own changes the checksum */
+static void testOptions(void)
+{
+	uint32_t flags, seed, sum, plain;
+	int p, n;
+
+	printf("Options\n");
+	for (p = 0; p < CRC_POLY_LAST; p++) {
+		for (n = 0; n < 8; n++) {
+			seed = (n == 0) ? 0 : (n == 1) ? 0xFFFFFFFF : nextRandom();
+			plain = swCrc((CRC_POLY_T) p, 0, seed, data, sizeof(data));
+			for (flags = 0; flags <= 0x3C; flags += CRC_MODE_WRDATA_BIT_RVS) {
+				sum = swCrc((CRC_POLY_T) p, flags, seed, data, sizeof(data));
+				check(sum == refCrc((CRC_POLY_T) p, flags, seed, data, sizeof(data)),
+					  "differs from the reference", p, flags);
+				if ((flags & (flags - 1)) == 0) {
+					check((flags == 0) || (sum != plain), "option not applied", p, flags);
+				}
+			}
+		}
+	}
+}
+
+/* Split feeds against a single feed */
+static void testSplit(void)
+{
+	CRC_SW_T crc;
+	uint32_t flags, whole, i, j;
+	int p;
+
+	printf("Split feeds\n");
+	for (p = 0; p < CRC_POLY_LAST; p++) {
+		for (flags = 0; flags <= 0x3C; flags += CRC_MODE_WRDATA_BIT_RVS) {
+			whole = swCrc((CRC_POLY_T) p, flags, 0x12345678, data, 64);
+			for (i = 0; i <= 64; i++) {
+				for (j = i; j <= 64; j += 7) {
+					Chip_CRC_SWInit(&crc, (CRC_POLY_T) p, flags, 0x12345678);
+					Chip_CRC_SWUpdate(&crc, data, i);
+					Chip_CRC_SWSum(&crc);
+					Chip_CRC_SWUpdate(&crc, &data[i], j - i);
+					Chip_CRC_SWUpdate(&crc, &data[j], 64 - j);
+					if (Chip_CRC_SWSum(&crc) != whole) {
+						check(false, "split feed differs", p, flags);
+						break;
+					}
+				}
+			}
+		}
+	}
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Run the software CRC checks */
+int main(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < sizeof(data); i++) {
+		data[i] = (uint8_t) nextRandom();
+	}
+
+	testDefaults();
+	testCatalogue();
+	testOptions();
+	testSplit();
+
+	if (failures) {
+		printf("FAIL: CRC software fallback, %d checks\n", failures);
+		return 1;
+	}
+	printf("PASS: CRC software fallback\n");
+	return 0;
+}
@@ -0,0 +1,327 @@
+/*
+ * @brief DMA driver test against a RAM register model
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2012
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "chip.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Register block in RAM. Set/clear and write-1-to-clear registers keep the
+   last value written, the tests load what the hardware would return. */
+static LPC_DMA_T regs;
+
+/* Stand-in for a peripheral data register */
+static volatile uint32_t periphReg;
+
+/* Events seen by the channel callback */
+static int numEvents;
+static DMA_CHID_T lastCh;
+static DMA_EVENT_T lastEvent;
+
+/* Re-arm the completed ping-pong half from the callback */
+static bool rearm;
+
+static int failures;
+
+#define CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			printf("FAIL: %s:%d: %s\n", __FILE__, __LINE__, # cond); \
+			failures++; \
+		} \
+	} while (0)
+
+#define ADDR(p)     ((uint32_t) (uintptr_t) (p))
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Record the channel events */
+static void dmaCallback(DMA_CHID_T ch, DMA_EVENT_T event)
+{
+	DMA_CHDESC_T *pDesc;
+
+	numEvents++;
+	lastCh = ch;
+	lastEvent = event;
+	if (rearm && (event != DMA_EVENT_ERROR)) {
+		pDesc = Chip_DMA_GetDesc(ch, event == DMA_EVENT_ALT_DONE);
+		pDesc->ctrl = pDesc->reload;
+	}
+}
+
+/* Reset the model and the driver */
+static void setup(void)
+{
+	memset(&regs, 0xA5, sizeof(regs));
+	Chip_DMA_Setup(&regs);
+	memset(&regs, 0, sizeof(regs));
+	numEvents = 0;
+	rearm = false;
+}
+
+/* Complete the cycle of a channel: the controller marks the descriptor
+   stopped, disables the channel and raises its done flag */
+static void completeCycle(DMA_CHID_T ch, bool alt)
+{
+	Chip_DMA_GetDesc(ch, alt)->ctrl &= ~(DMA_CTRL_CYCLE_MASK | DMA_CTRL_N_MINUS_1_MASK);
+	regs.CHNL_ENABLE_SET &= ~(1 << ch);
+	regs.CHNL_IRQ_STATUS = (1 << ch);
+}
+
+/* Initialization programs the controller and the descriptor table */
+static void testSetup(void)
+{
+	DMA_CHDESC_T *pDesc;
+	int i;
+
+	memset(&regs, 0xA5, sizeof(regs));
+	Chip_DMA_Setup(&regs);
+
+	CHECK(regs.CFG == DMA_CFG_MASTER_EN);
+	CHECK(regs.CTRL_BASE_PTR == ADDR(Chip_DMA_GetDesc(DMA_CH_UART0_TX, false)));
+	CHECK((regs.CTRL_BASE_PTR & (DMA_TABLE_ALIGN - 1)) == 0);
+	CHECK(regs.CHNL_ENABLE_CLR == 0x1FFFFF);
+	CHECK(regs.CHNL_IRQ_ENABLE == 0);
+	CHECK(regs.CHNL_IRQ_STATUS == 0x1FFFFF);
+	CHECK(regs.IRQ_ERR_ENABLE == 1);
+
+	/* Alternate descriptors start DMA_TABLE_ENTRIES entries in */
+	CHECK(Chip_DMA_GetDesc(DMA_CH_SW1, true) ==
+		  Chip_DMA_GetDesc(DMA_CH_UART0_TX, false) + DMA_TABLE_ENTRIES + DMA_CH_SW1);
+	for (i = 0; i < DMA_CHANNEL_NUM; i++) {
+		pDesc = Chip_DMA_GetDesc((DMA_CHID_T) i, false);
+		CHECK((pDesc->ctrl & DMA_CTRL_CYCLE_MASK) == DMA_CTRL_CYCLE_STOP);
+	}
+}
+
+/* Descriptor end addresses and the transfer count limits */
+static void testSetupDesc(void)
+{
+	static uint32_t src[16];
+	static uint8_t dst[16];
+	DMA_CHDESC_T desc;
+	uint32_t ctrl;
+
+	ctrl = DMA_CTRL_CYCLE_BASIC | DMA_XFER_MEM2MEM_32;
+	CHECK(Chip_DMA_SetupDesc(&desc, ctrl, src, dst, 16) == SUCCESS);
+	CHECK(desc.srcEnd == ADDR(&src[15]));
+	CHECK(desc.dstEnd == ADDR(dst) + 15 * 4);
+	CHECK(DMA_CTRL_GET_COUNT(desc.ctrl) == 16);
+	CHECK(desc.reload == desc.ctrl);
+
+	/* Fixed peripheral address */
+	CHECK(Chip_DMA_SetupDesc(&desc, DMA_XFER_MEM2PER_8, dst, &periphReg, 10) == SUCCESS);
+	CHECK(desc.srcEnd == ADDR(&dst[9]));
+	CHECK(desc.dstEnd == ADDR(&periphReg));
+
+	CHECK(Chip_DMA_SetupDesc(&desc, ctrl, src, dst, DMA_MAX_XFER) == SUCCESS);
+	CHECK(DMA_CTRL_GET_COUNT(desc.ctrl) == DMA_MAX_XFER);
+	CHECK(Chip_DMA_SetupDesc(&desc, ctrl, src, dst, 0) == ERROR);
+	CHECK(Chip_DMA_SetupDesc(&desc, ctrl, src, dst, DMA_MAX_XFER + 1) == ERROR);
+}
+
+/* A memory transfer is started by software and completes once */
+static void testTransfer(void)
+{
+	static uint32_t src[8], dst[8];
+	DMA_CHDESC_T *pDesc = Chip_DMA_GetDesc(DMA_CH_SW0, false);
+	uint32_t irqDisables;
+
+	setup();
+	Chip_DMA_SetCallback(DMA_CH_SW0, dmaCallback);
+	hostPrimask = 0;
+	irqDisables = hostIrqDisables;
+
+	CHECK(Chip_DMA_Transfer(&regs, DMA_CH_SW0, DMA_CTRL_CYCLE_AUTO | DMA_XFER_MEM2MEM_32, src, dst, 8) == SUCCESS);
+	CHECK((pDesc->ctrl & DMA_CTRL_CYCLE_MASK) == DMA_CTRL_CYCLE_AUTO);
+	CHECK(pDesc->srcEnd == ADDR(&src[7]));
+	CHECK(pDesc->dstEnd == ADDR(&dst[7]));
+	CHECK(regs.CHNL_ENABLE_SET == (1 << DMA_CH_SW0));
+	CHECK(regs.CHNL_SW_REQUEST == (1 << DMA_CH_SW0));
+	CHECK(regs.CHNL_PRI_ALT_CLR == (1 << DMA_CH_SW0));
+	CHECK(regs.CHNL_IRQ_ENABLE == (1 << DMA_CH_SW0));
+
+	/* The interrupt enable update masks interrupts and restores PRIMASK */
+	CHECK(hostIrqDisables == irqDisables + 1);
+	CHECK(hostPrimask == 0);
+
+	/* Nothing happens until the channel flags completion. The driver
+	   cleared the stale flag, which reads back as 0. */
+	CHECK(regs.CHNL_IRQ_STATUS == (1 << DMA_CH_SW0));
+	regs.CHNL_IRQ_STATUS = 0;
+	Chip_DMA_IRQHandler(&regs);
+	CHECK(numEvents == 0);
+
+	completeCycle(DMA_CH_SW0, false);
+	Chip_DMA_IRQHandler(&regs);
+	CHECK(numEvents == 1);
+	CHECK(lastCh == DMA_CH_SW0);
+	CHECK(lastEvent == DMA_EVENT_PRI_DONE);
+	CHECK(regs.CHNL_IRQ_STATUS == (1 << DMA_CH_SW0));
+
+	/* Peripheral cycles are turned into basic cycles and not triggered */
+	regs.CHNL_SW_REQUEST = 0;
+	CHECK(Chip_DMA_Transfer(&regs, DMA_CH_UART0_TX, DMA_CTRL_CYCLE_PINGPONG | DMA_XFER_MEM2PER_8,
+							src, &periphReg, 4) == SUCCESS);
+	CHECK((Chip_DMA_GetDesc(DMA_CH_UART0_TX, false)->ctrl & DMA_CTRL_CYCLE_MASK) == DMA_CTRL_CYCLE_BASIC);
+	CHECK(regs.CHNL_SW_REQUEST == 0);
+	CHECK(regs.CHNL_IRQ_ENABLE == ((1 << DMA_CH_SW0) | (1 << DMA_CH_UART0_TX)));
+
+	CHECK(Chip_DMA_Transfer(&regs, DMA_CH_SW1, DMA_CTRL_CYCLE_AUTO, src, dst, 0) == ERROR);
+}
+
+/* Ping-pong halves complete alternately and resume once re-armed */
+static void testPingPong(void)
+{
+	static uint8_t buf[2][16];
+	const volatile void *const src[2] = {&periphReg, &periphReg};
+	volatile void *const dst[2] = {buf[0], buf[1]};
+	DMA_CHDESC_T *pPri = Chip_DMA_GetDesc(DMA_CH_UART1_RX, false);
+	DMA_CHDESC_T *pAlt = Chip_DMA_GetDesc(DMA_CH_UART1_RX, true);
+	uint32_t mask = (1 << DMA_CH_UART1_RX);
+
+	setup();
+	Chip_DMA_SetCallback(DMA_CH_UART1_RX, dmaCallback);
+	CHECK(Chip_DMA_PingPong(&regs, DMA_CH_UART1_RX, DMA_XFER_PER2MEM_8, src, dst, 16) == SUCCESS);
+	CHECK((pPri->ctrl & DMA_CTRL_CYCLE_MASK) == DMA_CTRL_CYCLE_PINGPONG);
+	CHECK((pAlt->ctrl & DMA_CTRL_CYCLE_MASK) == DMA_CTRL_CYCLE_PINGPONG);
+	CHECK(pAlt->dstEnd == ADDR(&buf[1][15]));
+
+	/* Primary done, controller moved on to the alternate */
+	rearm = true;
+	completeCycle(DMA_CH_UART1_RX, false);
+	regs.CHNL_ENABLE_SET = mask;
+	regs.CHNL_PRI_ALT_SET = mask;
+	Chip_DMA_IRQHandler(&regs);
+	CHECK(numEvents == 1);
+	CHECK(lastEvent == DMA_EVENT_PRI_DONE);
+	CHECK((pPri->ctrl & DMA_CTRL_CYCLE_MASK) == DMA_CTRL_CYCLE_PINGPONG);
+
+	/* Alternate done while the callback is late: the controller found a
+	   stopped primary and disabled the channel */
+	rearm = false;
+	completeCycle(DMA_CH_UART1_RX, true);
+	pPri->ctrl &= ~DMA_CTRL_CYCLE_MASK;
+	regs.CHNL_PRI_ALT_SET = 0;
+	regs.CHNL_ENABLE_SET = 0;
+	Chip_DMA_IRQHandler(&regs);
+	CHECK(numEvents == 3);
+	CHECK(regs.CHNL_ENABLE_SET == 0);
+
+	/* Once the primary is handed back the channel is resumed */
+	pPri->ctrl = pPri->reload;
+	regs.CHNL_IRQ_STATUS = mask;
+	numEvents = 0;
+	Chip_DMA_IRQHandler(&regs);
+	CHECK(regs.CHNL_ENABLE_SET == mask);
+}
+
+/* Scatter-gather chains the tasks through the alternate descriptor */
+static void testScatterGather(void)
+{
+	static uint32_t a[4], b[4], c[4], d[4];
+	DMA_CHDESC_T tasks[2];
+	DMA_CHDESC_T *pPri = Chip_DMA_GetDesc(DMA_CH_SW1, false);
+	DMA_CHDESC_T *pAlt = Chip_DMA_GetDesc(DMA_CH_SW1, true);
+
+	setup();
+	Chip_DMA_SetupDesc(&tasks[0], DMA_XFER_MEM2MEM_32, a, b, 4);
+	Chip_DMA_SetupDesc(&tasks[1], DMA_XFER_MEM2MEM_32, c, d, 4);
+	CHECK(Chip_DMA_ScatterGather(&regs, DMA_CH_SW1, tasks, 2, false) == SUCCESS);
+
+	CHECK((tasks[0].ctrl & DMA_CTRL_CYCLE_MASK) == DMA_CTRL_CYCLE_MEM_SG_ALT);
+	CHECK((tasks[1].ctrl & DMA_CTRL_CYCLE_MASK) == DMA_CTRL_CYCLE_AUTO);
+	CHECK((pPri->ctrl & DMA_CTRL_CYCLE_MASK) == DMA_CTRL_CYCLE_MEM_SG_PRI);
+	CHECK(DMA_CTRL_GET_COUNT(pPri->ctrl) == 8);
+	CHECK(pPri->srcEnd == ADDR(&tasks[1].reload));
+	CHECK(pPri->dstEnd == ADDR(&pAlt->reload));
+	CHECK(regs.CHNL_SW_REQUEST == (1 << DMA_CH_SW1));
+
+	CHECK(Chip_DMA_ScatterGather(&regs, DMA_CH_SW1, tasks, 0, false) == ERROR);
+}
+
+/* A bus error fails the started channels that went idle */
+static void testError(void)
+{
+	static uint32_t src[4], dst[4];
+
+	setup();
+	Chip_DMA_SetCallback(DMA_CH_SW0, dmaCallback);
+	Chip_DMA_SetCallback(DMA_CH_SW1, dmaCallback);
+	Chip_DMA_Transfer(&regs, DMA_CH_SW0, DMA_CTRL_CYCLE_AUTO, src, dst, 4);
+	Chip_DMA_Transfer(&regs, DMA_CH_SW1, DMA_CTRL_CYCLE_AUTO, src, dst, 4);
+
+	/* SW0 faulted and was disabled, SW1 is still running */
+	regs.CHNL_IRQ_STATUS = 0;
+	regs.CHNL_ENABLE_SET = (1 << DMA_CH_SW1);
+	regs.ERR_CLR = 1;
+	Chip_DMA_IRQHandler(&regs);
+	CHECK(numEvents == 1);
+	CHECK(lastCh == DMA_CH_SW0);
+	CHECK(lastEvent == DMA_EVENT_ERROR);
+	CHECK(regs.CHNL_IRQ_ENABLE == (1 << DMA_CH_SW1));
+
+	/* An aborted channel no longer reports */
+	Chip_DMA_Abort(&regs, DMA_CH_SW1);
+	CHECK(regs.CHNL_IRQ_ENABLE == 0);
+	CHECK(regs.CHNL_ENABLE_CLR == (1 << DMA_CH_SW1));
+	regs.ERR_CLR = 1;
+	regs.CHNL_ENABLE_SET = 0;
+	Chip_DMA_IRQHandler(&regs);
+	CHECK(numEvents == 1);
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Run the DMA driver tests */
+int main(void)
+{
+	testSetup();
+	testSetupDesc();
+	testTransfer();
+	testPingPong();
+	testScatterGather();
+	testError();
+
+	if (failures) {
+		printf("FAIL: DMA driver, %d checks failed\n", failures);
+		return 1;
+	}
+	printf("PASS: DMA driver\n");
+	return 0;
+}
@@ -0,0 +1,190 @@
+/*
+ * @brief I2C SCL timing solver test table
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2012
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <stdio.h>
+#include "chip.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Reference setups */
+static const struct {
+	uint32_t clkin;
+	I2C_BUSMODE_T mode;
+	uint32_t rate;
+	uint32_t riseNs;
+	uint16_t sclh;
+	uint16_t scll;
+	uint32_t achieved;
+} refTable[] = {
+	{12000000, I2C_BUS_STANDARD, 100000, 0, 55, 65, 100000},
+	{12000000, I2C_BUS_FAST, 400000, 0, 10, 20, 400000},
+	{12000000, I2C_BUS_FASTPLUS, 1000000, 0, 5, 7, 1000000},
+	{24000000, I2C_BUS_FAST, 400000, 100, 19, 39, 397350},
+	{24000000, I2C_BUS_FASTPLUS, 1000000, 50, 9, 14, 991735},
+	{30000000, I2C_BUS_FASTPLUS, 1000000, 0, 11, 19, 1000000},
+	{45000000, I2C_BUS_STANDARD, 100000, 1000, 186, 219, 100000},
+	{45000000, I2C_BUS_FAST, 400000, 300, 32, 67, 400000},
+	{45000000, I2C_BUS_FASTPLUS, 1000000, 120, 14, 26, 991189},
+	{1000000, I2C_BUS_FAST, 400000, 0, 4, 4, 125000},
+};
+
+/* Timing minimums and maximum rise times of the bus modes from the I2C
+   specification */
+static const struct {
+	uint32_t maxRate;
+	uint32_t lowNs;
+	uint32_t highNs;
+	uint32_t riseNs;
+} spec[] = {
+	{100000, 4700, 4000, 1000},	/* I2C_BUS_STANDARD */
+	{400000, 1300, 600, 300},	/* I2C_BUS_FAST */
+	{1000000, 500, 260, 120},	/* I2C_BUS_FASTPLUS */
+};
+
+/* Main clocks from the IRC, the system oscillator, the PLL and the
+   watchdog oscillator, and the SYSAHBCLKDIV values tried for each */
+static const uint32_t mainClocks[] = {
+	1000000, 4000000, 8000000, 12000000, 15000000, 18000000,
+	24000000, 30000000, 33000000, 36000000, 45000000
+};
+static const uint32_t sysDividers[] = {1, 2, 3, 4, 6, 8, 16};
+
+/* Target rates of each mode */
+static const uint32_t rates[][4] = {
+	{10000, 50000, 80000, 100000},
+	{100000, 250000, 333000, 400000},
+	{400000, 600000, 800000, 1000000},
+};
+
+static int failures;
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Check a solver result against the bus mode timing rules */
+static void checkClock(uint32_t clkin, I2C_BUSMODE_T mode, uint32_t rate, uint32_t riseNs)
+{
+	I2C_CLOCK_T clk;
+	uint64_t period, target, achieved;
+	uint32_t total;
+
+	if (Chip_I2C_CalcClock(clkin, mode, rate, riseNs, &clk) != SUCCESS) {
+		printf("FAIL: %lu Hz, mode %d, %lu Hz, %lu ns: no timing\n", (unsigned long) clkin, mode,
+			   (unsigned long) rate, (unsigned long) riseNs);
+		failures++;
+		return;
+	}
+
+	/* Periods in units of 1 / (clkin * rate) ns */
+	total = clk.sclh + clk.scll;
+	period = ((uint64_t) total * 1000000000 + (uint64_t) riseNs * clkin) * rate;
+	target = (uint64_t) clkin * 1000000000;
+	achieved = ((uint64_t) clkin * 1000000000) / ((uint64_t) total * 1000000000 + (uint64_t) riseNs * clkin);
+
+	if ((clk.scll < 4) || (clk.sclh < 4) ||
+		((uint64_t) clk.scll * 1000000000 < (uint64_t) spec[mode].lowNs * clkin) ||
+		((uint64_t) clk.sclh * 1000000000 < (uint64_t) spec[mode].highNs * clkin)) {
+		printf("FAIL: %lu Hz, mode %d, %lu Hz: SCLL %u SCLH %u below the minimums\n",
+			   (unsigned long) clkin, mode, (unsigned long) rate, clk.scll, clk.sclh);
+		failures++;
+	}
+	if (period < target) {
+		printf("FAIL: %lu Hz, mode %d, %lu Hz: faster than the target\n",
+			   (unsigned long) clkin, mode, (unsigned long) rate);
+		failures++;
+	}
+
+	/* One clock less would be too fast, unless the minimums set the period */
+	if ((period - ((uint64_t) 1000000000 * rate) >= target) &&
+		((clk.scll > 4) && ((uint64_t) (clk.scll - 1) * 1000000000 >= (uint64_t) spec[mode].lowNs * clkin))) {
+		printf("FAIL: %lu Hz, mode %d, %lu Hz: SCLL %u SCLH %u is not the shortest period\n",
+			   (unsigned long) clkin, mode, (unsigned long) rate, clk.scll, clk.sclh);
+		failures++;
+	}
+	if (clk.clockrate != achieved) {
+		printf("FAIL: %lu Hz, mode %d, %lu Hz: reported %lu Hz, achieved %lu Hz\n", (unsigned long) clkin,
+			   mode, (unsigned long) rate, (unsigned long) clk.clockrate, (unsigned long) achieved);
+		failures++;
+	}
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Run the reference table and all the main clock configurations */
+int main(void)
+{
+	I2C_CLOCK_T clk;
+	uint32_t i, d, m, r, clkin;
+	uint32_t rise[4];
+	int cases = 0;
+	int k;
+
+	for (i = 0; i < sizeof(refTable) / sizeof(refTable[0]); i++) {
+		if ((Chip_I2C_CalcClock(refTable[i].clkin, refTable[i].mode, refTable[i].rate, refTable[i].riseNs,
+								&clk) != SUCCESS) || (clk.sclh != refTable[i].sclh) ||
+			(clk.scll != refTable[i].scll) || (clk.clockrate != refTable[i].achieved)) {
+			printf("FAIL: reference %lu: SCLH %u SCLL %u %lu Hz\n", (unsigned long) i, clk.sclh, clk.scll,
+				   (unsigned long) clk.clockrate);
+			failures++;
+		}
+		cases++;
+	}
+
+	for (i = 0; i < sizeof(mainClocks) / sizeof(mainClocks[0]); i++) {
+		for (d = 0; d < sizeof(sysDividers) / sizeof(sysDividers[0]); d++) {
+			clkin = mainClocks[i] / sysDividers[d];
+			for (m = I2C_BUS_STANDARD; m <= I2C_BUS_FASTPLUS; m++) {
+				rise[0] = 0;
+				rise[1] = 20;
+				rise[2] = spec[m].riseNs / 2;
+				rise[3] = spec[m].riseNs;
+				for (r = 0; r < 4; r++) {
+					for (k = 0; k < 4; k++) {
+						checkClock(clkin, (I2C_BUSMODE_T) m, rates[m][r], rise[k]);
+						cases++;
+					}
+				}
+			}
+		}
+	}
+
+	if (failures) {
+		printf("FAIL: I2C SCL timing solver, %d of %d cases\n", failures, cases);
+		return 1;
+	}
+	printf("PASS: I2C SCL timing solver, %d cases\n", cases);
+	return 0;
+}
@@ -0,0 +1,188 @@
+/*
+ * @brief Ring buffer SPSC stress test
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2012
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "ring_buffer.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define RB_ITEMS            64
+#define BATCH_MAX           (RB_ITEMS + 8)
+
+/* Ring buffer shared by the producer and the consumer thread */
+static RINGBUFF_T rb;
+static uint32_t rbData[RB_ITEMS];
+
+/* Number of items to transfer */
+static uint32_t numItems = 1000000000UL;
+
+/* First sequence error seen by the consumer */
+static volatile int failed;
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Small pseudo random generator to vary the call mix */
+static uint32_t nextRand(uint32_t *state)
+{
+	uint32_t x = *state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+/* Insert sequence numbers until numItems have been written */
+static void *producer(void *arg)
+{
+	uint32_t buf[BATCH_MAX];
+	uint32_t seq = 0, rnd = 0x12345678;
+	RINGBUFF_SPAN_T span[2];
+	uint32_t *p;
+	int i, n, num;
+
+	(void) arg;
+	while ((seq < numItems) && !failed) {
+		num = (int) MIN((nextRand(&rnd) % BATCH_MAX) + 1, numItems - seq);
+
+		switch (nextRand(&rnd) & 3) {
+		case 0:
+			n = RingBuffer_Insert(&rb, &seq);
+			break;
+
+		case 1:
+			for (i = 0; i < num; i++) {
+				buf[i] = seq + i;
+			}
+			n = RingBuffer_InsertMult(&rb, buf, num);
+			break;
+
+		default:
+			n = MIN(RingBuffer_ReserveWrite(&rb, span), num);
+			for (i = 0; i < n; i++) {
+				p = (i < span[0].count) ? (uint32_t *) span[0].data + i :
+					(uint32_t *) span[1].data + (i - span[0].count);
+				*p = seq + i;
+			}
+			n = RingBuffer_CommitWrite(&rb, n);
+			break;
+		}
+
+		if (n == 0) {
+			sched_yield();
+		}
+		seq += n;
+	}
+	return NULL;
+}
+
+/* Pop items and check that each sequence number arrives exactly once */
+static void *consumer(void *arg)
+{
+	uint32_t buf[BATCH_MAX];
+	uint32_t seq = 0, rnd = 0x87654321;
+	RINGBUFF_SPAN_T span[2];
+	uint32_t v;
+	int i, n, num;
+
+	(void) arg;
+	while ((seq < numItems) && !failed) {
+		num = (int) (nextRand(&rnd) % BATCH_MAX) + 1;
+
+		switch (nextRand(&rnd) & 3) {
+		case 0:
+			n = RingBuffer_Pop(&rb, buf);
+			break;
+
+		case 1:
+			n = RingBuffer_PopMult(&rb, buf, num);
+			break;
+
+		default:
+			n = MIN(RingBuffer_PeekRead(&rb, span), num);
+			for (i = 0; i < n; i++) {
+				buf[i] = (i < span[0].count) ? ((uint32_t *) span[0].data)[i] :
+						 ((uint32_t *) span[1].data)[i - span[0].count];
+			}
+			n = RingBuffer_ConsumeRead(&rb, n);
+			break;
+		}
+
+		for (i = 0; i < n; i++) {
+			v = buf[i];
+			if (v != seq) {
+				printf("FAIL: expected item %lu, got %lu\n", (unsigned long) seq, (unsigned long) v);
+				failed = 1;
+				break;
+			}
+			seq++;
+		}
+		if (n == 0) {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Run the producer and the consumer in two threads */
+int main(int argc, char *argv[])
+{
+	pthread_t prod, cons;
+
+	if (argc > 1) {
+		numItems = (uint32_t) strtoul(argv[1], NULL, 0);
+	}
+
+	RingBuffer_Init(&rb, rbData, sizeof(rbData[0]), RB_ITEMS);
+	pthread_create(&cons, NULL, consumer, NULL);
+	pthread_create(&prod, NULL, producer, NULL);
+	pthread_join(prod, NULL);
+	pthread_join(cons, NULL);
+
+	if (failed || !RingBuffer_IsEmpty(&rb)) {
+		printf("FAIL: ring buffer SPSC stress, %d items left\n", RingBuffer_GetCount(&rb));
+		return 1;
+	}
+	printf("PASS: ring buffer SPSC stress, %lu items\n", (unsigned long) numItems);
+	return 0;
+}
@@ -0,0 +1,595 @@
+/*
+ * @brief SPI NOR flash driver test against an in-memory flash simulator
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2012
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "spi_nor.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Erase opcodes understood by the simulator */
+#define CMD_BE32K           0x52
+
+/* Status reads a page program or an erase stays busy for */
+#define PROGRAM_POLLS       3
+#define ERASE_POLLS         5
+
+/* Simulated memory size, devices may report a larger size */
+#define SIM_MEM_SIZE        (1UL << 20)
+
+/* Size of the SFDP area */
+#define SIM_SFDP_SIZE       0x100
+
+/* Largest number of erase commands logged */
+#define SIM_MAX_LOG         64
+
+/* In-memory SPI NOR flash, driven one byte at a time */
+typedef struct {
+	uint8_t mem[SIM_MEM_SIZE];
+	uint8_t sfdp[SIM_SFDP_SIZE];
+	bool hasSfdp;				/* false reads the SFDP area as 0xFF */
+	uint8_t id[3];
+	uint32_t pageSize;
+
+	/* Command state */
+	bool selected;
+	uint32_t pos;				/* Bytes clocked since the chip select */
+	uint8_t opcode;
+	uint32_t addr;
+	uint8_t page[256];
+	uint32_t pageLen;
+	bool wel;
+	uint32_t busy;				/* Status reads left with WIP set */
+	bool stuck;					/* WIP never clears */
+	bool failTransfer;			/* Transfers return ERROR */
+
+	/* Erase log and protocol violations */
+	uint8_t eraseOp[SIM_MAX_LOG];
+	uint32_t eraseAddr[SIM_MAX_LOG];
+	uint32_t numErase;
+	uint32_t programs;
+	int violations;
+} SIM_T;
+
+/* Page program data source state */
+typedef struct {
+	SIM_T *sim;
+	uint32_t seed;
+	uint32_t calls;
+	uint32_t idleCalls;			/* Calls after the first with the device idle */
+} FILL_T;
+
+static SIM_T sim;
+static uint8_t wbuf[SIM_MEM_SIZE], rbuf[SIM_MEM_SIZE];
+
+static int failures;
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Report a failed check */
+static void check(bool ok, const char *what)
+{
+	if (!ok) {
+		printf("  %s\n", what);
+		failures++;
+	}
+}
+
+/* Size of an erase opcode, 0 if the opcode is not an erase */
+static uint32_t simEraseSize(uint8_t opcode)
+{
+	switch (opcode) {
+	case SPINOR_CMD_SE:
+		return 1UL << 12;
+
+	case CMD_BE32K:
+		return 1UL << 15;
+
+	case SPINOR_CMD_BE:
+		return 1UL << 16;
+
+	default:
+		return 0;
+	}
+}
+
+/* Clock one byte through the device, returns the byte it sends back */
+static uint8_t simClock(SIM_T *s, uint8_t in)
+{
+	uint32_t pos = s->pos++;
+
+	if (pos == 0) {
+		s->opcode = in;
+		s->addr = 0;
+		s->pageLen = 0;
+		/* Only the status may be read while the device is busy */
+		if ((s->busy != 0) && (in != SPINOR_CMD_RDSR)) {
+			s->violations++;
+		}
+		return 0xFF;
+	}
+
+	switch (s->opcode) {
+	case SPINOR_CMD_RDID:
+		return (pos <= 3) ? s->id[pos - 1] : 0xFF;
+
+	case SPINOR_CMD_RDSR:
+		if ((s->busy != 0) && !s->stuck && (--s->busy == 0)) {
+			s->wel = false;
+		}
+		return (s->busy ? SPINOR_SR_WIP : 0) | (s->wel ? SPINOR_SR_WEL : 0);
+
+	default:
+		break;
+	}
+
+	/* Commands with a 3 byte address */
+	if (pos <= 3) {
+		s->addr = (s->addr << 8) | in;
+		return 0xFF;
+	}
+	switch (s->opcode) {
+	case SPINOR_CMD_SFDP:
+		if ((pos == 4) || !s->hasSfdp || ((s->addr + pos - 5) >= SIM_SFDP_SIZE)) {
+			return 0xFF;
+		}
+		return s->sfdp[s->addr + pos - 5];
+
+	case SPINOR_CMD_FAST_READ:
+		return (pos == 4) ? 0xFF : s->mem[(s->addr + pos - 5) % SIM_MEM_SIZE];
+
+	case SPINOR_CMD_PP:
+		/* Data past the end of the page wraps to its start, as on a real device */
+		if (s->pageLen == s->pageSize) {
+			s->violations++;
+		}
+		else {
+			s->page[s->pageLen++] = in;
+		}
+		return 0xFF;
+
+	default:
+		return 0xFF;
+	}
+}
+
+/* Run a command at the end of the chip select */
+static void simDeselect(SIM_T *s)
+{
+	uint32_t size, base, i;
+
+	if (s->pos == 0) {
+		return;
+	}
+	if ((s->opcode == SPINOR_CMD_WREN) && (s->pos == 1)) {
+		s->wel = true;
+	}
+	else if ((s->opcode == SPINOR_CMD_PP) && (s->pos >= 5)) {
+		if (!s->wel) {
+			s->violations++;
+			return;
+		}
+		base = s->addr & ~(s->pageSize - 1);
+		for (i = 0; i < s->pageLen; i++) {
+			/* Programming only clears bits */
+			s->mem[(base + ((s->addr + i) & (s->pageSize - 1))) % SIM_MEM_SIZE] &= s->page[i];
+		}
+		s->programs++;
+		s->busy = PROGRAM_POLLS;
+	}
+	else if ((size = simEraseSize(s->opcode)) != 0) {
+		if (!s->wel || (s->pos != 4)) {
+			s->violations++;
+			return;
+		}
+		if (s->numErase < SIM_MAX_LOG) {
+			s->eraseOp[s->numErase] = s->opcode;
+			s->eraseAddr[s->numErase] = s->addr;
+		}
+		s->numErase++;
+		base = s->addr & ~(size - 1);
+		memset(&s->mem[base % SIM_MEM_SIZE], 0xFF, MIN(size, SIM_MEM_SIZE));
+		s->busy = ERASE_POLLS;
+	}
+}
+
+/* Bus chip select */
+static void simSelect(void *bus, bool assert)
+{
+	SIM_T *s = (SIM_T *) bus;
+
+	if (assert == s->selected) {
+		s->violations++;
+	}
+	if (!assert) {
+		simDeselect(s);
+	}
+	s->selected = assert;
+	s->pos = 0;
+}
+
+/* Bus transfer */
+static Status simTransfer(void *bus, const uint8_t *tx, uint8_t *rx, uint32_t len)
+{
+	SIM_T *s = (SIM_T *) bus;
+	uint32_t i;
+	uint8_t in;
+
+	if (!s->selected) {
+		s->violations++;
+	}
+	if (s->failTransfer) {
+		return ERROR;
+	}
+	for (i = 0; i < len; i++) {
+		in = simClock(s, tx ? tx[i] : 0xFF);
+		if (rx) {
+			rx[i] = in;
+		}
+	}
+
+	return SUCCESS;
+}
+
+static const SPINOR_BUS_T simBus = {
+	simSelect,
+	simTransfer,
+};
+
+/* Little endian DWORD into the SFDP area */
+static void simSetDword(uint8_t *p, uint32_t v)
+{
+	p[0] = (uint8_t) v;
+	p[1] = (uint8_t) (v >> 8);
+	p[2] = (uint8_t) (v >> 16);
+	p[3] = (uint8_t) (v >> 24);
+}
+
+/* Reset the simulator to an erased device without SFDP */
+static void simReset(uint32_t jedecId)
+{
+	memset(&sim, 0, sizeof(sim));
+	memset(sim.mem, 0xFF, sizeof(sim.mem));
+	sim.id[0] = (uint8_t) (jedecId >> 16);
+	sim.id[1] = (uint8_t) (jedecId >> 8);
+	sim.id[2] = (uint8_t) jedecId;
+	sim.pageSize = 256;
+}
+
+/* Add an SFDP area with a vendor table ahead of the basic flash parameter
+   table, which has numDwords DWORDs. The erase DWORDs 8 and 9 and DWORD 1
+   have the 4 KB erase opcode, DWORD 11 the page size of up to 256 bytes. */
+static void simSetSfdp(uint32_t numDwords, uint32_t dw1, uint32_t density,
+					   uint32_t dw8, uint32_t dw9, uint32_t pageShift)
+{
+	uint8_t *p = sim.sfdp;
+
+	memset(sim.sfdp, 0xFF, sizeof(sim.sfdp));
+	sim.hasSfdp = true;
+
+	/* Header, 2 parameter headers */
+	simSetDword(&p[0], 0x50444653);
+	p[4] = 6;
+	p[5] = 1;
+	p[6] = 1;
+
+	/* 4 byte address instruction table, not used by the driver */
+	p[8] = 0x84;
+	p[9] = 0;
+	p[10] = 1;
+	p[11] = 2;
+	p[12] = 0xC0;
+	p[13] = 0;
+	p[14] = 0;
+	p[15] = 0xFF;
+	simSetDword(&p[0xC0], 0);
+	simSetDword(&p[0xC4], 0);
+
+	/* Basic flash parameter table */
+	p[16] = 0x00;
+	p[17] = 6;
+	p[18] = 1;
+	p[19] = (uint8_t) numDwords;
+	p[20] = 0x30;
+	p[21] = 0;
+	p[22] = 0;
+	p[23] = 0xFF;
+
+	p += 0x30;
+	memset(p, 0, numDwords * 4);
+	simSetDword(&p[0], dw1);
+	simSetDword(&p[4], density);
+	simSetDword(&p[28], dw8);
+	simSetDword(&p[32], dw9);
+	if (numDwords >= 11) {
+		simSetDword(&p[40], pageShift << 4);
+	}
+	sim.pageSize = 1UL << pageShift;
+}
+
+/* Check the detected geometry, erase types are given as shift/opcode
+   pairs largest first */
+static void checkGeometry(SPINOR_T *flash, const char *name, bool sfdp, uint32_t size,
+						  uint32_t pageSize, const uint8_t *erase, int numErase)
+{
+	int i;
+
+	printf("%s\n", name);
+	check(flash->jedecId == (uint32_t) ((sim.id[0] << 16) | (sim.id[1] << 8) | sim.id[2]),
+		  "wrong JEDEC ID");
+	check(flash->sfdp == sfdp, "wrong SFDP flag");
+	check(flash->size == size, "wrong size");
+	check(flash->pageSize == pageSize, "wrong page size");
+	for (i = 0; i < SPINOR_ERASE_TYPES; i++) {
+		if (i < numErase) {
+			check((flash->erase[i].shift == erase[i * 2]) &&
+				  (flash->erase[i].opcode == erase[(i * 2) + 1]), "wrong erase type");
+		}
+		else {
+			check(flash->erase[i].shift == 0, "unexpected erase type");
+		}
+	}
+	check(sim.violations == 0, "protocol violation");
+}
+
+/* SFDP device with 4 KB, 32 KB and 64 KB erase listed out of order */
+static void initSfdp(SPINOR_T *flash, uint32_t pageShift)
+{
+	simReset(0xEF4014);
+	simSetSfdp(16, 0x000020E5, (8UL << 20) - 1, 0x200CD810, 0x0000520F, pageShift);
+	SpiNor_Init(flash, &simBus, &sim);
+}
+
+/* Detection from the JEDEC ID and SFDP */
+static void testDetect(void)
+{
+	static const uint8_t sfdpErase[] = {16, SPINOR_CMD_BE, 15, CMD_BE32K, 12, SPINOR_CMD_SE};
+	static const uint8_t idErase[] = {16, SPINOR_CMD_BE, 12, SPINOR_CMD_SE};
+	static const uint8_t dw1Erase[] = {12, 0x21};
+	SPINOR_T flash;
+	Status ret;
+
+	initSfdp(&flash, 8);
+	checkGeometry(&flash, "SFDP device", true, 1UL << 20, 256, sfdpErase, 3);
+
+	/* JESD216 table without DWORD 11, density as 2^N beyond 16 MB */
+	simReset(0xC22018);
+	simSetSfdp(9, 0x000020E5, (1UL << 31) | 34, 0x0000D810, 0x0000200C, 8);
+	ret = SpiNor_Init(&flash, &simBus, &sim);
+	check(ret == SUCCESS, "JESD216 device not detected");
+	checkGeometry(&flash, "JESD216 device", true, 1UL << 24, 256, idErase, 2);
+
+	/* Only the 4 KB erase of DWORD 1 */
+	simReset(0x1F4501);
+	simSetSfdp(11, 0x000021E5, (4UL << 20) - 1, 0, 0, 6);
+	ret = SpiNor_Init(&flash, &simBus, &sim);
+	check(ret == SUCCESS, "DWORD 1 erase device not detected");
+	checkGeometry(&flash, "SFDP device with DWORD 1 erase only", true, 512UL << 10, 64, dw1Erase, 1);
+
+	/* No SFDP, the size comes from the capacity byte */
+	simReset(0x202014);
+	ret = SpiNor_Init(&flash, &simBus, &sim);
+	check(ret == SUCCESS, "non-SFDP device not detected");
+	checkGeometry(&flash, "Non-SFDP fallback", false, 1UL << 20, 256, idErase, 2);
+
+	/* Basic table too short to use, falls back to the JEDEC ID */
+	simReset(0x202015);
+	simSetSfdp(8, 0x000020E5, (8UL << 20) - 1, 0x0000D810, 0, 8);
+	ret = SpiNor_Init(&flash, &simBus, &sim);
+	check(ret == SUCCESS, "short SFDP device not detected");
+	checkGeometry(&flash, "Short SFDP table fallback", false, 2UL << 20, 256, idErase, 2);
+
+	printf("Rejected devices\n");
+	simReset(0xFFFFFF);
+	check(SpiNor_Init(&flash, &simBus, &sim) == ERROR, "missing device accepted");
+	simReset(0);
+	check(SpiNor_Init(&flash, &simBus, &sim) == ERROR, "zero JEDEC ID accepted");
+	simReset(0x202040);
+	check(SpiNor_Init(&flash, &simBus, &sim) == ERROR, "unknown capacity accepted");
+	simReset(0xEF4019);
+	simSetSfdp(16, 0x000420E5, (256UL << 20) - 1, 0x0000D810, 0, 8);
+	check(SpiNor_Init(&flash, &simBus, &sim) == ERROR, "4 byte address only device accepted");
+	simReset(0xEF4014);
+	simSetSfdp(16, 0x000000E4, (8UL << 20) - 1, 0, 0, 8);
+	check(SpiNor_Init(&flash, &simBus, &sim) == ERROR, "device without erase accepted");
+	simReset(0xEF4014);
+	sim.failTransfer = true;
+	check(SpiNor_Init(&flash, &simBus, &sim) == ERROR, "bus error ignored");
+}
+
+/* Erase an area and check the commands and the memory contents, ops NULL
+   only checks the number of commands */
+static void checkErase(SPINOR_T *flash, uint32_t addr, uint32_t len,
+					   const uint8_t *ops, const uint32_t *addrs, uint32_t num)
+{
+	uint32_t i;
+
+	memset(sim.mem, 0, sizeof(sim.mem));
+	sim.numErase = 0;
+	check(SpiNor_Erase(flash, addr, len) == SUCCESS, "erase failed");
+	check(sim.numErase == num, "wrong number of erase commands");
+	for (i = 0; ops && (i < num) && (i < sim.numErase); i++) {
+		check((sim.eraseOp[i] == ops[i]) && (sim.eraseAddr[i] == addrs[i]), "wrong erase command");
+	}
+	for (i = 0; i < SIM_MEM_SIZE; i++) {
+		if (sim.mem[i] != (((i >= addr) && (i < (addr + len))) ? 0xFF : 0)) {
+			check(false, "wrong area erased");
+			break;
+		}
+	}
+	check(sim.violations == 0, "protocol violation");
+}
+
+/* Erase type selection */
+static void testErase(void)
+{
+	static const uint8_t ops1[] = {
+		SPINOR_CMD_SE, SPINOR_CMD_SE, SPINOR_CMD_SE, SPINOR_CMD_SE, SPINOR_CMD_SE,
+		SPINOR_CMD_SE, SPINOR_CMD_SE, CMD_BE32K, SPINOR_CMD_BE, SPINOR_CMD_BE,
+		CMD_BE32K, SPINOR_CMD_SE
+	};
+	static const uint32_t addrs1[] = {
+		0x01000, 0x02000, 0x03000, 0x04000, 0x05000, 0x06000,
+		0x07000, 0x08000, 0x10000, 0x20000, 0x30000, 0x38000
+	};
+	static const uint8_t ops2[] = {SPINOR_CMD_SE, SPINOR_CMD_BE, SPINOR_CMD_SE};
+	static const uint32_t addrs2[] = {0x0F000, 0x10000, 0x20000};
+	SPINOR_T flash;
+
+	printf("Erase with 4 KB, 32 KB and 64 KB types\n");
+	initSfdp(&flash, 8);
+	check(SpiNor_GetEraseSize(&flash) == 0x1000, "wrong smallest erase size");
+	checkErase(&flash, 0x01000, 0x38000, ops1, addrs1, sizeof(ops1));
+	checkErase(&flash, 0x10000, 0x10000, &ops1[8], &addrs1[8], 1);
+	checkErase(&flash, 0, SIM_MEM_SIZE, NULL, NULL, SIM_MEM_SIZE >> 16);
+	check(SpiNor_Erase(&flash, 0x800, 0x1000) == ERROR, "misaligned address accepted");
+	check(SpiNor_Erase(&flash, 0x1000, 0x800) == ERROR, "misaligned length accepted");
+	check(SpiNor_Erase(&flash, SIM_MEM_SIZE - 0x1000, 0x2000) == ERROR, "erase past the end accepted");
+	check(SpiNor_Erase(&flash, 0, 0) == SUCCESS, "empty erase failed");
+
+	printf("Erase with the non-SFDP fallback types\n");
+	simReset(0x202014);
+	SpiNor_Init(&flash, &simBus, &sim);
+	checkErase(&flash, 0x0F000, 0x12000, ops2, addrs2, sizeof(ops2));
+
+	printf("Erase timeout\n");
+	sim.stuck = true;
+	check(SpiNor_Erase(&flash, 0, 0x1000) == ERROR, "timeout not reported");
+}
+
+/* Page program data source, a pseudo random sequence seeded by the offset */
+static void fillData(void *arg, uint8_t *buf, uint32_t offset, uint32_t len)
+{
+	FILL_T *f = (FILL_T *) arg;
+	uint32_t i;
+
+	if ((f->calls++ != 0) && (f->sim->busy == 0)) {
+		f->idleCalls++;
+	}
+	for (i = 0; i < len; i++) {
+		buf[i] = (uint8_t) (((offset + i) * 2654435761UL + f->seed) >> 13);
+	}
+}
+
+/* Program, read back and compare an area of an erased device */
+static void checkProgram(SPINOR_T *flash, uint32_t addr, uint32_t len, bool useFill)
+{
+	static uint8_t pageBuf[256];
+	FILL_T fill = {&sim, addr, 0, 0};
+	uint32_t pages = ((addr & (flash->pageSize - 1)) + len + flash->pageSize - 1) / flash->pageSize;
+	uint32_t i;
+
+	memset(sim.mem, 0xFF, sizeof(sim.mem));
+	sim.programs = 0;
+	fillData(&fill, wbuf, 0, len);
+	fill.calls = 0;
+	if (useFill) {
+		check(SpiNor_ProgramFill(flash, addr, len, fillData, &fill, pageBuf) == SUCCESS,
+			  "program from data source failed");
+		check(fill.calls == pages, "wrong number of data source calls");
+		check(fill.idleCalls == 0, "data source called with the device idle");
+	}
+	else {
+		check(SpiNor_Program(flash, addr, wbuf, len) == SUCCESS, "program failed");
+	}
+	check(sim.programs == pages, "wrong number of page programs");
+
+	memset(rbuf, 0, sizeof(rbuf));
+	check(SpiNor_Read(flash, addr, rbuf, len) == SUCCESS, "read failed");
+	check(memcmp(rbuf, wbuf, len) == 0, "read back differs");
+	for (i = 0; i < SIM_MEM_SIZE; i++) {
+		if (((i < addr) || (i >= (addr + len))) && (sim.mem[i] != 0xFF)) {
+			check(false, "programmed outside the area");
+			break;
+		}
+	}
+	check(sim.violations == 0, "protocol violation");
+}
+
+/* Program and read back */
+static void testProgram(void)
+{
+	SPINOR_T flash;
+	int i;
+
+	for (i = 0; i < 2; i++) {
+		printf("Program and read back, %s\n", i ? "data source" : "buffer");
+		initSfdp(&flash, 8);
+		checkProgram(&flash, 0, 256, i);
+		checkProgram(&flash, 0x1234, 1, i);
+		checkProgram(&flash, 0x10F0, 0x20, i);
+		checkProgram(&flash, 0x20081, 5000, i);
+		checkProgram(&flash, 0, SIM_MEM_SIZE, i);
+
+		/* 64 byte pages from SFDP DWORD 11 */
+		initSfdp(&flash, 6);
+		checkProgram(&flash, 0x3F, 0x1000, i);
+	}
+
+	printf("Program and read limits\n");
+	initSfdp(&flash, 8);
+	check(SpiNor_Program(&flash, SIM_MEM_SIZE - 1, wbuf, 2) == ERROR, "program past the end accepted");
+	check(SpiNor_Read(&flash, SIM_MEM_SIZE, rbuf, 1) == ERROR, "read past the end accepted");
+	check(SpiNor_Read(&flash, 0xFFFFFFFF, rbuf, 2) == ERROR, "wrapping read accepted");
+	check(SpiNor_Read(&flash, SIM_MEM_SIZE, rbuf, 0) == SUCCESS, "empty read failed");
+	check(SpiNor_Program(&flash, 0, wbuf, 0) == SUCCESS, "empty program failed");
+	check(sim.programs == 0, "empty program sent a command");
+	sim.failTransfer = true;
+	check(SpiNor_Read(&flash, 0, rbuf, 16) == ERROR, "read bus error ignored");
+	check(SpiNor_Program(&flash, 0, wbuf, 16) == ERROR, "program bus error ignored");
+	sim.failTransfer = false;
+	sim.stuck = true;
+	check(SpiNor_Program(&flash, 0, wbuf, 16) == ERROR, "program timeout not reported");
+	check(sim.violations == 0, "protocol violation");
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Run the driver against the simulator */
+int main(void)
+{
+	testDetect();
+	testErase();
+	testProgram();
+
+	if (failures) {
+		printf("FAIL: SPI NOR flash driver, %d checks\n", failures);
+		return 1;
+	}
+	printf("PASS: SPI NOR flash driver\n");
+	return 0;
+}
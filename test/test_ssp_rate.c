@@ -0,0 +1,151 @@
+/*
+ * @brief SSP bit rate solver test against brute force
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2012
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <stdio.h>
+#include "chip.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Main clocks from the IRC, the system oscillator, the PLL and the
+   watchdog oscillator */
+static const uint32_t mainClocks[] = {
+	1000000, 4000000, 8000000, 12000000, 15000000, 18000000,
+	24000000, 30000000, 33000000, 36000000, 45000000
+};
+
+/* Number of bit rates per clock, spread logarithmically from 10 bit/s up
+   to the clock rate */
+#define NUM_RATES           300
+
+static int failures;
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Try every SSP0CLKDIV and CPSR with the smallest SCR that is not too fast.
+   Returns the smallest total divider, 0 if none fits, and the largest
+   SSP0CLKDIV giving it. */
+static uint32_t bruteForce(uint32_t clkin, uint32_t bitRate, uint32_t *bestDiv)
+{
+	uint32_t minTotal = (clkin + bitRate - 1) / bitRate;
+	uint32_t div, cpsr, scr1, total, best = 0;
+
+	*bestDiv = 0;
+	for (div = 1; div <= 255; div++) {
+		for (cpsr = 2; cpsr <= 254; cpsr += 2) {
+			scr1 = (minTotal + (div * cpsr) - 1) / (div * cpsr);
+			if (scr1 > 256) {
+				continue;
+			}
+			total = div * cpsr * scr1;
+			if ((best == 0) || (total < best) || ((total == best) && (div > *bestDiv))) {
+				best = total;
+				*bestDiv = div;
+			}
+		}
+	}
+	return best;
+}
+
+/* Check the solver against the brute force search for one bit rate */
+static void checkRate(uint32_t clkin, uint32_t bitRate)
+{
+	SSP_CLOCK_T clk;
+	uint32_t best, bestDiv, total;
+	Status status;
+
+	best = bruteForce(clkin, bitRate, &bestDiv);
+	status = Chip_SSP_CalcBitRate(clkin, bitRate, &clk);
+
+	if (best == 0) {
+		if (status != ERROR) {
+			printf("FAIL: %lu Hz, %lu bit/s: accepted an unreachable rate\n", (unsigned long) clkin,
+				   (unsigned long) bitRate);
+			failures++;
+		}
+		return;
+	}
+	if (status != SUCCESS) {
+		printf("FAIL: %lu Hz, %lu bit/s: rejected\n", (unsigned long) clkin, (unsigned long) bitRate);
+		failures++;
+		return;
+	}
+
+	total = (uint32_t) clk.clkDiv * clk.cpsr * (clk.scr + 1);
+	if ((clk.clkDiv == 0) || (clk.cpsr < 2) || (clk.cpsr & 1) || (total != best) ||
+		(clk.clkDiv != bestDiv) || (clk.bitRate != (clkin / total)) || (clk.bitRate > bitRate)) {
+		printf("FAIL: %lu Hz, %lu bit/s: CLKDIV %u CPSR %u SCR %u, best divider %lu with CLKDIV %lu\n",
+			   (unsigned long) clkin, (unsigned long) bitRate, clk.clkDiv, clk.cpsr, clk.scr,
+			   (unsigned long) best, (unsigned long) bestDiv);
+		failures++;
+	}
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Run the solver over a range of bit rates for each main clock */
+int main(void)
+{
+	uint32_t i, r, rate;
+	double step;
+	int cases = 0;
+
+	for (i = 0; i < sizeof(mainClocks) / sizeof(mainClocks[0]); i++) {
+		step = 1.0;
+		for (r = 0; r < NUM_RATES; r++) {
+			rate = (uint32_t) (10 * step);
+			checkRate(mainClocks[i], rate);
+			checkRate(mainClocks[i], rate + 1);
+			cases += 2;
+			while ((uint32_t) (10 * step) == rate) {
+				step *= 1.0 + (1.0 / NUM_RATES) * 18.0;
+			}
+			if ((10 * step) > mainClocks[i]) {
+				break;
+			}
+		}
+		checkRate(mainClocks[i], mainClocks[i]);
+		checkRate(mainClocks[i], 1);
+		cases += 2;
+	}
+
+	if (failures) {
+		printf("FAIL: SSP bit rate solver, %d of %d cases\n", failures, cases);
+		return 1;
+	}
+	printf("PASS: SSP bit rate solver, %d cases\n", cases);
+	return 0;
+}
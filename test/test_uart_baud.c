@@ -0,0 +1,170 @@
+/*
+ * @brief UART baud rate solver test against brute force
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2012
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <stdio.h>
+#include "chip.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Standard baud rates */
+static const uint32_t baudRates[] = {
+	1200, 2400, 4800, 9600, 14400, 19200, 28800, 38400, 57600, 76800,
+	115200, 230400, 250000, 460800, 500000, 921600, 1000000, 1500000
+};
+
+/* Main clock rates from the IRC, the system oscillator and the PLL */
+static const uint32_t mainClocks[] = {
+	12000000, 18000000, 24000000, 30000000, 33000000, 36000000, 45000000
+};
+
+/* Highest UARTnCLKDIV value */
+#define MAX_CLKDIV          255
+
+static int failures;
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Error of a divider setup as the fraction diff / den of the target rate */
+static void getError(uint32_t clkin, uint32_t baudrate, uint32_t dl, uint32_t mul, uint32_t add,
+					 uint64_t *diff, uint64_t *den)
+{
+	uint64_t num = (uint64_t) clkin * mul;
+	uint64_t rate;
+
+	*den = (uint64_t) 16 * dl * (mul + add);
+	rate = *den * baudrate;
+	*diff = (num > rate) ? (num - rate) : (rate - num);
+}
+
+/* Search every DL, DIVADDVAL and MULVAL for the smallest error. DL values
+   giving a rate outside half to twice the target are skipped, their error
+   is above 50 % and cannot be the best of an accepted setup. */
+static void bruteForce(uint32_t clkin, uint32_t baudrate, bool useFDR, uint64_t *bestDiff, uint64_t *bestDen)
+{
+	uint32_t mul, add, dl, dlMin, dlMax;
+	uint64_t diff, den, exact;
+
+	*bestDiff = ~0ULL;
+	*bestDen = 1;
+	for (mul = 1; mul <= (useFDR ? 15 : 1); mul++) {
+		for (add = 0; add < mul; add++) {
+			exact = ((uint64_t) clkin * mul) / ((uint64_t) 16 * baudrate * (mul + add));
+			dlMin = (uint32_t) MAX(exact / 2, (add > 0) ? 3 : 1);
+			dlMax = (uint32_t) MIN((exact * 2) + 1, 0xFFFF);
+			for (dl = dlMin; dl <= dlMax; dl++) {
+				getError(clkin, baudrate, dl, mul, add, &diff, &den);
+				if (((unsigned __int128) diff * *bestDen) < ((unsigned __int128) *bestDiff * den)) {
+					*bestDiff = diff;
+					*bestDen = den;
+				}
+			}
+		}
+	}
+}
+
+/* Check the solver against the brute force search for one setup */
+static void checkBaud(uint32_t clkin, uint32_t baudrate, bool useFDR)
+{
+	UART_BAUD_T baud;
+	Status status;
+	uint64_t diff, den, bestDiff, bestDen, rate;
+	int64_t ppm;
+
+	bruteForce(clkin, baudrate, useFDR, &bestDiff, &bestDen);
+	ppm = (int64_t) ((bestDiff * 1000000) / bestDen) / baudrate;
+	status = Chip_UART_CalcBaud(clkin, baudrate, useFDR, &baud);
+
+	if (ppm > UART_BAUD_MAX_ERROR_PPM) {
+		if (status != ERROR) {
+			printf("FAIL: %lu Hz, %lu baud, FDR %d: accepted %ld ppm\n", (unsigned long) clkin,
+				   (unsigned long) baudrate, useFDR, (long) baud.errorPpm);
+			failures++;
+		}
+		return;
+	}
+	if (status != SUCCESS) {
+		printf("FAIL: %lu Hz, %lu baud, FDR %d: rejected, best is %ld ppm\n", (unsigned long) clkin,
+			   (unsigned long) baudrate, useFDR, (long) ppm);
+		failures++;
+		return;
+	}
+
+	/* The solver must find a setup as good as the best one */
+	getError(clkin, baudrate, baud.dl, baud.mulVal, baud.divAddVal, &diff, &den);
+	if (((unsigned __int128) diff * bestDen) != ((unsigned __int128) bestDiff * den)) {
+		printf("FAIL: %lu Hz, %lu baud, FDR %d: DL %u MULVAL %u DIVADDVAL %u is not the best\n",
+			   (unsigned long) clkin, (unsigned long) baudrate, useFDR, baud.dl, baud.mulVal, baud.divAddVal);
+		failures++;
+	}
+
+	/* Valid register values and consistent reported rate */
+	rate = ((uint64_t) clkin * baud.mulVal + (den / 2)) / den;
+	if ((baud.mulVal < 1) || (baud.mulVal > 15) || (baud.divAddVal >= baud.mulVal) ||
+		(!useFDR && (baud.divAddVal != 0)) || ((baud.divAddVal > 0) && (baud.dl < 3)) ||
+		(baud.dl == 0) || (baud.baudrate != rate) ||
+		((baud.errorPpm < 0 ? -baud.errorPpm : baud.errorPpm) != ppm)) {
+		printf("FAIL: %lu Hz, %lu baud, FDR %d: bad setup\n", (unsigned long) clkin,
+			   (unsigned long) baudrate, useFDR);
+		failures++;
+	}
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Run the solver over all standard rates and clock configurations */
+int main(void)
+{
+	uint32_t i, j, div;
+	int cases = 0;
+
+	for (i = 0; i < sizeof(mainClocks) / sizeof(mainClocks[0]); i++) {
+		for (div = 1; div <= MAX_CLKDIV; div++) {
+			for (j = 0; j < sizeof(baudRates) / sizeof(baudRates[0]); j++) {
+				checkBaud(mainClocks[i] / div, baudRates[j], false);
+				checkBaud(mainClocks[i] / div, baudRates[j], true);
+				cases += 2;
+			}
+		}
+	}
+
+	if (failures) {
+		printf("FAIL: UART baud rate solver, %d of %d cases\n", failures, cases);
+		return 1;
+	}
+	printf("PASS: UART baud rate solver, %d cases\n", cases);
+	return 0;
+}